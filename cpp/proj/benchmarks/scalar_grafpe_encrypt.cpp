@@ -0,0 +1,69 @@
+/*
+ * author: Adam Budziak
+ */
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+#include <grafpe/crypt/ScalarGrafpe.hpp>
+#include <grafpe/prng/utils.hpp>
+#include <grafpe/prng/DummyPRNG.hpp>
+
+
+int main() {
+    using namespace grafpe;
+    using namespace grafpe::crypter;
+    using prng_t = grafpe::aes::openssl::AesCtr128PRNG;
+
+    using namespace std::chrono;
+
+    uint64_t N = 1000, D = 4;
+    uint64_t walk_length = 100;
+    uint64_t tests = 100'000;
+
+    auto grafpe = ScalarGrafpe<prng_t> {
+        random_array<prng_t::key_type>(DummyPRNG{}),
+        random_array<prng_t::iv_type>(DummyPRNG{}),
+        N,
+        D,
+        walk_length
+    };
+
+    const auto run = [&](const char* name, auto tweak_of) {
+        point_t value = 0;
+        const auto stats_before = grafpe.walk_cache_stats();
+
+        auto start = high_resolution_clock::now();
+        for (uint64_t i = 0; i < tests; ++i) {
+            value = grafpe.encrypt(value, tweak_of(i));
+        }
+        auto end = high_resolution_clock::now();
+
+        const auto stats = grafpe.walk_cache_stats();
+        const auto hits = stats.hits - stats_before.hits;
+        const auto lookups = stats.lookups() - stats_before.lookups();
+
+        auto duration = duration_cast<nanoseconds>(end - start).count();
+        std::cout << name << '\t' << duration / (double)(tests) << " ns/op\t"
+                  << "hit rate: " << hits / (double)(lookups) << '\t' << value << '\n';
+    };
+
+    run("hot tweak", [](uint64_t) { return tweak_t{42}; });
+    run("distinct tweaks", [](uint64_t i) { return tweak_t{1'000'000 + i}; });
+
+    std::vector<point_t> column(tests);
+    for (uint64_t i = 0; i < tests; ++i) {
+        column[i] = i % N;
+    }
+
+    for (auto instruction_set : simd::all_supported()) {
+        auto start = high_resolution_clock::now();
+        grafpe.encrypt_batch(column.data(), column.data(), column.size(), tweak_t{42}, instruction_set);
+        auto end = high_resolution_clock::now();
+
+        auto duration = duration_cast<nanoseconds>(end - start).count();
+        std::cout << "batch (" << simd::to_string(instruction_set) << ")\t"
+                  << duration / (double)(tests) << " ns/op\t" << column[0] << '\n';
+    }
+}
@@ -0,0 +1,105 @@
+/*
+ * author: Adam Budziak
+ */
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include <grafpe/aes/openssl/AesCtr128PRNG.hpp>
+#include <grafpe/crypt/ScalarGrafpe.hpp>
+#include <grafpe/prng/utils.hpp>
+#include <grafpe/prng/DummyPRNG.hpp>
+#include <grafpe/service/Client.hpp>
+#include <grafpe/service/Server.hpp>
+
+/*
+ * Load generator of the encryption daemon: several clients send batches of
+ * a given size to an in-process Server; the throughput is compared with
+ * encrypting the same values directly, which is the upper bound for the daemon.
+ */
+
+using namespace grafpe;
+using namespace grafpe::crypter;
+
+constexpr uint64_t N = 1u << 16u;
+constexpr uint64_t VALUES_PER_CLIENT = 1u << 18u;
+
+void run(const std::string& path, std::size_t clients_cnt, std::size_t batch) {
+    using namespace std::chrono;
+
+    std::vector<std::thread> clients;
+    auto start = high_resolution_clock::now();
+    for (std::size_t c = 0; c < clients_cnt; ++c) {
+        clients.emplace_back([&path, batch, c] {
+            service::Client client{path};
+            std::vector<uint64_t> values(batch);
+            for (uint64_t done = 0; done < VALUES_PER_CLIENT; done += batch) {
+                for (std::size_t i = 0; i < batch; ++i) {
+                    values[i] = (done + i + c) % N;
+                }
+                client.encrypt(0, values.data(), values.data(), batch, tweak_t{42});
+            }
+        });
+    }
+    for (auto& client : clients) {
+        client.join();
+    }
+    auto end = high_resolution_clock::now();
+
+    const auto duration = duration_cast<nanoseconds>(end - start).count();
+    const auto values = clients_cnt * VALUES_PER_CLIENT;
+    const auto requests = values / batch;
+    std::cout << clients_cnt << " clients, batch " << batch << '\t'
+              << values * 1e9 / duration << " values/s\t"
+              << duration / 1e3 * clients_cnt / requests << " us/request\n";
+}
+
+int main() {
+    using prng_t = grafpe::aes::openssl::AesCtr128PRNG;
+    using namespace std::chrono;
+
+    const uint64_t D = 4;
+    const uint64_t walk_length = 100;
+
+    auto grafpe = ScalarGrafpe<prng_t> {
+        random_array<prng_t::key_type>(DummyPRNG{}),
+        random_array<prng_t::iv_type>(DummyPRNG{}),
+        N,
+        D,
+        walk_length
+    };
+
+    {
+        std::vector<uint64_t> values(VALUES_PER_CLIENT);
+        for (uint64_t i = 0; i < values.size(); ++i) {
+            values[i] = i % N;
+        }
+        std::vector<uint64_t> encrypted(values.size());
+        // the first batch under a tweak decodes its walk, the daemon pays for it only once too
+        grafpe.encrypt_batch(values.data(), encrypted.data(), values.size(), tweak_t{42});
+
+        auto start = high_resolution_clock::now();
+        grafpe.encrypt_batch(values.data(), encrypted.data(), values.size(), tweak_t{42});
+        auto end = high_resolution_clock::now();
+        const auto duration = duration_cast<nanoseconds>(end - start).count();
+        std::cout << "in-process batch\t" << values.size() * 1e9 / duration << " values/s\n";
+    }
+
+    const auto path = "/tmp/grafpe_service_load_" + std::to_string(getpid()) + ".sock";
+    service::Server server{path, {service::make_batch_crypter(grafpe)}};
+    std::thread loop{[&server] { server.run(); }};
+
+    for (std::size_t clients : {1, 4}) {
+        for (std::size_t batch : {1, 16, 256, 4096}) {
+            run(path, clients, batch);
+        }
+    }
+
+    server.stop();
+    loop.join();
+}
@@ -0,0 +1,166 @@
+/*
+ * author: Adam Budziak
+ */
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+#include <grafpe/crypt/Cast.hpp>
+#include <grafpe/crypt/ScalarGrafpe.hpp>
+#include <grafpe/crypt/Static.hpp>
+#include <grafpe/crypt/Targeted.hpp>
+#include <grafpe/domain/CycleSlicer.hpp>
+#include <grafpe/domain/CycleWalker.hpp>
+#include <grafpe/prng/utils.hpp>
+#include <grafpe/prng/DummyPRNG.hpp>
+
+#if defined(_MSC_VER)
+#define NOINLINE __declspec(noinline)
+#else
+#define NOINLINE __attribute__((noinline))
+#endif
+
+/*
+ * Compares Targeted<CycleWalker<CastCrypter<X>>, CastCrypter<X>> composed
+ * through the virtual interfaces and std::function with its static counterpart.
+ * X is either ScalarGrafpe or a trivial affine permutation, so that the cost
+ * of the dispatch itself is visible. The same is done with a CycleSlicer
+ * in place of the CycleWalker, where the round PRFs dominate.
+ */
+
+using namespace grafpe;
+using namespace grafpe::crypter;
+using grafpe::domain::targeting::CS_Seed;
+
+constexpr uint64_t N = 1000;
+constexpr uint64_t SLICER_ROUNDS = 20;
+
+// x -> 7x + 3 (mod N), cheap enough for the composition to dominate
+point_t affine_forward(point_t x) { return (7 * x + 3) % N; }
+point_t affine_backward(point_t x) { return (143 * (x + N - 3)) % N; }
+
+class VirtualAffine: public Base<point_t> {
+    point_t encrypt_impl(const point_t& x, const tweak_t&) const override {
+        return affine_forward(x);
+    }
+    point_t decrypt_impl(const point_t& x, const tweak_t&) const override {
+        return affine_backward(x);
+    }
+};
+
+class StaticAffine: public StaticBase<StaticAffine, point_t> {
+    friend StaticBase<StaticAffine, point_t>;
+    point_t encrypt_impl(const point_t& x, const tweak_t&) const {
+        return affine_forward(x);
+    }
+    point_t decrypt_impl(const point_t& x, const tweak_t&) const {
+        return affine_backward(x);
+    }
+};
+
+template <typename Crypter_T>
+class U32Crypter: public CastCrypter<Crypter_T, uint32_t> {
+ public:
+    using CastCrypter<Crypter_T, uint32_t>::CastCrypter;
+ protected:
+    point_t cast_impl(const uint32_t& value) const override { return value; }
+    uint32_t uncast_impl(const point_t& value) const override { return static_cast<uint32_t>(value); }
+};
+
+bool in_domain(const uint32_t& x) { return x % 3 != 0; }
+
+template <typename Crypter_T>
+auto make_virtual(Crypter_T inner) {
+    using cast_t = U32Crypter<Crypter_T>;
+    using walker_t = domain::targeting::CycleWalker<cast_t>;
+    return Targeted<walker_t, cast_t>{walker_t{in_domain}, cast_t{std::move(inner)}};
+}
+
+template <typename Crypter_T>
+auto make_static(Crypter_T inner) {
+    auto cast = StaticCastCrypter{std::move(inner),
+                                  [](uint32_t value) { return point_t{value}; },
+                                  [](point_t value) { return static_cast<uint32_t>(value); }};
+    auto walker = domain::targeting::make_cycle_walker<decltype(cast)>(
+            [](const uint32_t& x) { return x % 3 != 0; });
+    return StaticTargeted{std::move(walker), std::move(cast)};
+}
+
+template <typename Crypter_T>
+auto make_virtual_slicer(Crypter_T inner, const CS_Seed& seed) {
+    using cast_t = U32Crypter<Crypter_T>;
+    using slicer_t = domain::targeting::CycleSlicer<cast_t>;
+    auto both_in_domain = [](const uint32_t& a, const uint32_t& b) { return in_domain(a) && in_domain(b); };
+    return Targeted<slicer_t, cast_t>{slicer_t{seed, both_in_domain, SLICER_ROUNDS}, cast_t{std::move(inner)}};
+}
+
+template <typename Crypter_T>
+auto make_static_slicer(Crypter_T inner, const CS_Seed& seed) {
+    auto cast = StaticCastCrypter{std::move(inner),
+                                  [](uint32_t value) { return point_t{value}; },
+                                  [](point_t value) { return static_cast<uint32_t>(value); }};
+    auto slicer = domain::targeting::make_cycle_slicer<decltype(cast)>(seed,
+            [](const uint32_t& a, const uint32_t& b) { return a % 3 != 0 && b % 3 != 0; }, SLICER_ROUNDS);
+    return StaticTargeted{std::move(slicer), std::move(cast)};
+}
+
+// not inlined, so that the dynamic type of a Base is not known at the call site
+template <typename Crypter_T>
+NOINLINE void run(const char* name, const Crypter_T& crypter, uint64_t tests) {
+    using namespace std::chrono;
+
+    // independent inputs, so that the latency of the arithmetic doesn't hide the dispatch;
+    // every input has to be in the domain, otherwise its cycle may not reach the domain at all
+    std::vector<uint32_t> inputs;
+    for (uint32_t x = 0; x < N; ++x) {
+        if (in_domain(x)) { inputs.push_back(x); }
+    }
+
+    uint64_t checksum = 0;
+    auto start = high_resolution_clock::now();
+    for (uint64_t i = 0; i < tests; ++i) {
+        checksum += crypter.encrypt(inputs[i % inputs.size()], tweak_t{42});
+    }
+    auto end = high_resolution_clock::now();
+
+    auto duration = duration_cast<nanoseconds>(end - start).count();
+    std::cout << name << '\t' << duration / (double)(tests) << " ns/op\t" << checksum << '\n';
+}
+
+int main() {
+    using prng_t = grafpe::aes::openssl::AesCtr128PRNG;
+
+    const uint64_t D = 4;
+    const uint64_t walk_length = 16;
+
+    auto grafpe = ScalarGrafpe<prng_t> {
+        random_array<prng_t::key_type>(DummyPRNG{}),
+        random_array<prng_t::iv_type>(DummyPRNG{}),
+        N,
+        D,
+        walk_length
+    };
+
+    {
+        auto virtual_stack = make_virtual(VirtualAffine{});
+        const Base<uint32_t>& virtual_ref = virtual_stack;
+        run("affine, virtual", virtual_ref, 10'000'000);
+        run("affine, static", make_static(StaticAffine{}), 10'000'000);
+        run("affine, static behind Dynamic", static_cast<const Base<uint32_t>&>(Dynamic{make_static(StaticAffine{})}),
+            10'000'000);
+    }
+    {
+        auto virtual_stack = make_virtual(grafpe);
+        const Base<uint32_t>& virtual_ref = virtual_stack;
+        run("ScalarGrafpe, virtual", virtual_ref, 1'000'000);
+        run("ScalarGrafpe, static", make_static(grafpe), 1'000'000);
+    }
+    {
+        const CS_Seed seed {random_array<prng_t::key_type>(DummyPRNG{}), random_array<prng_t::iv_type>(DummyPRNG{})};
+        auto virtual_stack = make_virtual_slicer(VirtualAffine{}, seed);
+        const Base<uint32_t>& virtual_ref = virtual_stack;
+        run("affine, CycleSlicer, virtual", virtual_ref, 1'000'000);
+        run("affine, CycleSlicer, static", make_static_slicer(StaticAffine{}, seed), 1'000'000);
+    }
+}
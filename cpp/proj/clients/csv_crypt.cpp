@@ -0,0 +1,201 @@
+/*
+ * author: Adam Budziak
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <pur/argparser/ArgParser.hpp>
+#include <dfare/common/Alphabet.hpp>
+#include <dfare/dfa/RankedDFA.hpp>
+#include <grafpe/aes/openssl/AesCtr128PRNG.hpp>
+#include <grafpe/common/print_utils.hpp>
+#include <grafpe/crypt/Codebook.hpp>
+#include <grafpe/crypt/Grafpe.hpp>
+#include <grafpe/crypt/RadixGrafpe.hpp>
+#include <grafpe/crypt/ScalarGrafpe.hpp>
+#include <grafpe/rte/Characters.hpp>
+#include <grafpe/rte/Container.hpp>
+#include <grafpe/rte/Csv.hpp>
+#include <grafpe/rte/DFA.hpp>
+
+/*
+ * Encrypts (or decrypts) the configured columns of a CSV file of any size.
+ *
+ * CsvCrypt --key HEX --iv HEX --columns SPEC [--input_file PATH] [--output_file PATH]
+ *          [--decrypt] [--header] [--delimiter C] [--threads N] [--tweak N]
+ *
+ * SPEC is a ';'-separated list of INDEX:KIND:PARAMS, the other columns are copied:
+ *   INDEX:int:N            - decimal numbers from {0, ..., N - 1} (ScalarGrafpe, RadixGrafpe for large N),
+ *                            others are an error
+ *   INDEX:dfa:LENGTH:REGEX - words of the given length matching the regex (rte::DFA)
+ *   INDEX:chars:ALPHABET   - strings of any length over the alphabet (rte::Characters with Grafpe)
+ *   INDEX:list:PATH        - one of the lines of the file (rte::Container)
+ * e.g. "0:int:100000;2:dfa:5:(a+b+c)*;3:chars:abcdefghijklmnopqrstuvwxyz"
+ *
+ * The input and output default to stdin and stdout.
+ */
+
+using namespace grafpe;
+using prng_t = aes::openssl::AesCtr128PRNG;
+
+constexpr std::size_t D = 4;
+constexpr std::size_t WALK_LENGTH = 100;
+// larger domains are split into digits (see RadixGrafpe)
+constexpr uint64_t MAX_GRAPH_SIZE = 1u << 16u;
+
+struct column_spec {
+    std::size_t index;
+    std::string kind;
+    std::string params;
+};
+
+std::vector<column_spec> parse_columns(const std::string& spec) {
+    std::vector<column_spec> columns;
+    std::size_t start = 0;
+    while (start <= spec.size()) {
+        auto stop = std::min(spec.find(';', start), spec.size());
+        auto column = spec.substr(start, stop - start);
+        start = stop + 1;
+        if (column.empty()) { continue; }
+
+        auto first = column.find(':');
+        auto second = column.find(':', first + 1);
+        if (first == std::string::npos || second == std::string::npos) {
+            throw std::invalid_argument("Invalid column spec: " + column);
+        }
+        columns.push_back({std::stoul(column.substr(0, first)),
+                           column.substr(first + 1, second - first - 1),
+                           column.substr(second + 1)});
+    }
+    return columns;
+}
+
+std::vector<std::string> read_lines(const std::string& path) {
+    std::ifstream ifs(path);
+    if (!ifs) {
+        throw std::invalid_argument("Couldn't open " + path);
+    }
+    std::vector<std::string> lines;
+    for (std::string line; std::getline(ifs, line);) {
+        lines.push_back(line);
+    }
+    return lines;
+}
+
+std::shared_ptr<const rte::Field> make_column(const column_spec& spec, const prng_t::key_type& key,
+                                              const prng_t::iv_type& iv) {
+    if (spec.kind == "int") {
+        const auto size = std::stoull(spec.params);
+        if (size <= MAX_GRAPH_SIZE) {
+            return rte::make_field(crypter::ScalarGrafpe<prng_t>{key, iv, size, D, WALK_LENGTH});
+        }
+        return rte::make_field(crypter::RadixGrafpe<prng_t>{key, iv, size, D, WALK_LENGTH});
+    }
+    if (spec.kind == "dfa") {
+        auto colon = spec.params.find(':');
+        if (colon == std::string::npos) {
+            throw std::invalid_argument("dfa column needs LENGTH:REGEX");
+        }
+        auto ranked = dfare::dfa::RankedDFA::from_string(spec.params.substr(colon + 1),
+                                                         std::stoul(spec.params.substr(0, colon)));
+        if (ranked.max_rank <= MAX_GRAPH_SIZE) {
+            return rte::make_field(rte::DFA{ranked, crypter::ScalarGrafpe<prng_t>{
+                key, iv, ranked.max_rank, D, WALK_LENGTH}});
+        }
+        return rte::make_field(rte::DFA{ranked, crypter::RadixGrafpe<prng_t>{
+            key, iv, ranked.max_rank, D, WALK_LENGTH}});
+    }
+    if (spec.kind == "chars") {
+        auto alphabet = dfare::Alphabet{spec.params};
+        return rte::make_field(rte::Characters{alphabet, crypter::Grafpe<prng_t>{
+            key, iv, alphabet.characters().size(), D, WALK_LENGTH}});
+    }
+    if (spec.kind == "list") {
+        auto lines = read_lines(spec.params);
+        const auto size = lines.size();
+        return rte::make_field(rte::Container{std::move(lines), crypter::Codebook{
+            crypter::ScalarGrafpe<prng_t>{key, iv, size, D, WALK_LENGTH}, size}});
+    }
+    throw std::invalid_argument("Unknown column kind: " + spec.kind);
+}
+
+int main(int argc, char **argv) {
+    pur::argparser::defaultParser parser{};
+    parser.register_arg<std::string>("key");
+    parser.register_arg<std::string>("iv");
+    parser.register_arg<std::string>("columns");
+    parser.register_arg<std::string>("input_file");
+    parser.register_arg<std::string>("output_file");
+    parser.register_arg<std::string>("delimiter");
+    parser.register_arg<int>("threads");
+    parser.register_arg<int>("tweak");
+    parser.register_arg<bool>("decrypt");
+    parser.register_arg<bool>("header");
+
+    parser.parse_program_params(argc, argv);
+
+    for (auto name : {"key", "iv", "columns"}) {
+        if (!parser.has_value(name)) {
+            std::cerr << name << " missing\n";
+            return 1;
+        }
+    }
+
+    const auto& key_str = parser.get_value<std::string>("key");
+    const auto& iv_str = parser.get_value<std::string>("iv");
+    if (!is_hex(key_str) || !is_hex(iv_str)) {
+        std::cerr << "Key or iv is not a proper hexstring\n";
+        return 1;
+    }
+    const auto key = hex_to_array<prng_t::key_type>(key_str);
+    const auto iv = hex_to_array<prng_t::iv_type>(iv_str);
+
+    std::FILE* in = stdin;
+    std::FILE* out = stdout;
+    try {
+        rte::CsvStream::columns_type columns;
+        for (const auto& spec : parse_columns(parser.get_value<std::string>("columns"))) {
+            if (columns.size() <= spec.index) {
+                columns.resize(spec.index + 1);
+            }
+            columns[spec.index] = make_column(spec, key, iv);
+        }
+
+        const auto delimiter = parser.has_value("delimiter") ? parser.get_value<std::string>("delimiter") : ",";
+        const auto threads = parser.has_value("threads") ? parser.get_value<int>("threads") : 0;
+        const auto tweak = tweak_t{static_cast<uint64_t>(parser.has_value("tweak") ? parser.get_value<int>("tweak") : 0)};
+        if (delimiter.size() != 1 || threads < 0) {
+            std::cerr << "Invalid delimiter or number of threads\n";
+            return 1;
+        }
+
+        if (parser.has_value("input_file") && !(in = std::fopen(parser.get_value<std::string>("input_file").c_str(), "rb"))) {
+            std::cerr << "Couldn't open the input file\n";
+            return 1;
+        }
+        if (parser.has_value("output_file") && !(out = std::fopen(parser.get_value<std::string>("output_file").c_str(), "wb"))) {
+            std::cerr << "Couldn't open the output file\n";
+            return 1;
+        }
+
+        rte::CsvStream stream{std::move(columns), delimiter[0], static_cast<std::size_t>(threads)};
+        if (parser.get_value<bool>("decrypt")) {
+            stream.decrypt(in, out, tweak, parser.get_value<bool>("header"));
+        } else {
+            stream.encrypt(in, out, tweak, parser.get_value<bool>("header"));
+        }
+    } catch (const std::exception& exc) {
+        std::cerr << exc.what() << '\n';
+        return 1;
+    }
+
+    if (in != stdin) { std::fclose(in); }
+    if (out != stdout && std::fclose(out) != 0) {
+        std::cerr << "Couldn't write the output file\n";
+        return 1;
+    }
+}
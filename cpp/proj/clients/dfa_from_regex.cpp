@@ -46,6 +46,10 @@ int main(int argc, char **argv) {
         << dfa.edges << '\n'
         << dfa.accepting_states << std::endl;
 
+    auto minimal = dfa.minimized();
+    std::cout << "states: " << minimal.built_states_count()
+              << " built, " << minimal.states.size() << " after minimization" << std::endl;
+
     auto ranked_dfa = RankedDFA::from_string(regex_str, 5);
 
     *os << ranked_dfa.get_rank_table() << '\n';
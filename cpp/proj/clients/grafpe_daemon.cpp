@@ -0,0 +1,103 @@
+/*
+ * author: Adam Budziak
+ */
+
+#include <csignal>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <pur/argparser/ArgParser.hpp>
+#include <grafpe/aes/openssl/AesCtr128PRNG.hpp>
+#include <grafpe/common/print_utils.hpp>
+#include <grafpe/crypt/RadixGrafpe.hpp>
+#include <grafpe/crypt/ScalarGrafpe.hpp>
+#include <grafpe/service/Server.hpp>
+
+/*
+ * Encryption daemon keeping the graphs in memory (see grafpe::service::Server).
+ *
+ * GrafpeDaemon --socket PATH --key HEX --iv HEX --domains N1;N2;...
+ *
+ * The i-th domain {0, ..., Ni - 1} is served under the crypter id i.
+ * SIGINT and SIGTERM stop the daemon and remove the socket.
+ */
+
+using namespace grafpe;
+using prng_t = aes::openssl::AesCtr128PRNG;
+
+constexpr std::size_t D = 4;
+constexpr std::size_t WALK_LENGTH = 100;
+// larger domains are split into digits (see RadixGrafpe)
+constexpr uint64_t MAX_GRAPH_SIZE = 1u << 16u;
+
+service::Server* running_server = nullptr;
+
+extern "C" void on_signal(int) {
+    if (running_server) {
+        running_server->stop();
+    }
+}
+
+std::vector<uint64_t> parse_domains(const std::string& spec) {
+    std::vector<uint64_t> domains;
+    std::size_t start = 0;
+    while (start <= spec.size()) {
+        auto stop = std::min(spec.find(';', start), spec.size());
+        auto domain = spec.substr(start, stop - start);
+        start = stop + 1;
+        if (!domain.empty()) {
+            domains.push_back(std::stoull(domain));
+        }
+    }
+    return domains;
+}
+
+int main(int argc, char **argv) {
+    pur::argparser::defaultParser parser{};
+    parser.register_arg<std::string>("socket");
+    parser.register_arg<std::string>("key");
+    parser.register_arg<std::string>("iv");
+    parser.register_arg<std::string>("domains");
+
+    parser.parse_program_params(argc, argv);
+
+    for (auto name : {"socket", "key", "iv", "domains"}) {
+        if (!parser.has_value(name)) {
+            std::cerr << name << " missing\n";
+            return 1;
+        }
+    }
+
+    const auto& key_str = parser.get_value<std::string>("key");
+    const auto& iv_str = parser.get_value<std::string>("iv");
+    if (!is_hex(key_str) || !is_hex(iv_str)) {
+        std::cerr << "Key or iv is not a proper hexstring\n";
+        return 1;
+    }
+    const auto key = hex_to_array<prng_t::key_type>(key_str);
+    const auto iv = hex_to_array<prng_t::iv_type>(iv_str);
+
+    try {
+        service::Server::crypters_type crypters;
+        for (auto N : parse_domains(parser.get_value<std::string>("domains"))) {
+            if (N <= MAX_GRAPH_SIZE) {
+                crypters.push_back(service::make_batch_crypter(crypter::ScalarGrafpe<prng_t>{key, iv, N, D, WALK_LENGTH}));
+            } else {
+                crypters.push_back(service::make_batch_crypter(crypter::RadixGrafpe<prng_t>{key, iv, N, D, WALK_LENGTH}));
+            }
+        }
+
+        service::Server server{parser.get_value<std::string>("socket"), std::move(crypters)};
+        running_server = &server;
+        std::signal(SIGINT, on_signal);
+        std::signal(SIGTERM, on_signal);
+
+        std::cerr << "Serving " << server.socket_path() << '\n';
+        server.run();
+        running_server = nullptr;
+    } catch (const std::exception& exc) {
+        std::cerr << exc.what() << '\n';
+        return 1;
+    }
+}
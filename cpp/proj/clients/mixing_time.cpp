@@ -0,0 +1,120 @@
+/*
+ * author: Adam Budziak
+ */
+
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include <pur/argparser/ArgParser.hpp>
+
+#include <grafpe/aes/openssl/AesCtr128PRNG.hpp>
+#include <grafpe/common/print_utils.hpp>
+#include <grafpe/graph/GraphBuilder.hpp>
+#include <grafpe/graph/mixing.hpp>
+#include <grafpe/prng/utils.hpp>
+#include <grafpe/prng/DummyPRNG.hpp>
+
+/*
+ * Estimates how long the walk on a graph has to be to get close to uniform.
+ *
+ * MixingTime --n N --d D [--key HEX --iv HEX] [--target BITS] [--threads T]
+ *            [--starts S] [--steps STEPS]
+ *
+ * The graph is built the same way as in ScalarGrafpe (random key and iv by default).
+ * Prints:
+ *  - an upper bound of the second largest absolute eigenvalue of the walk and the walk length
+ *    for which the spectral bound gives TVD <= 2^-BITS (BITS = 128 by default),
+ *  - log2(1/TVD) measured exactly for the walks from the first S vertices
+ *    (1 by default) after 1, ..., STEPS steps (64 by default), until it hits
+ *    the precision of doubles, and the walk length reaching 2^-BITS if it was reachable.
+ */
+
+using namespace grafpe;
+using prng_t = aes::openssl::AesCtr128PRNG;
+
+int main(int argc, char **argv) {
+    auto parser = pur::argparser::defaultParser{};
+    parser.register_arg<int>("n");
+    parser.register_arg<int>("d");
+    parser.register_arg<std::string>("key");
+    parser.register_arg<std::string>("iv");
+    parser.register_arg<int>("target");
+    parser.register_arg<int>("threads");
+    parser.register_arg<int>("starts");
+    parser.register_arg<int>("steps");
+
+    parser.parse_program_params(argc, argv);
+
+    if (!parser.has_value("n") || !parser.has_value("d")) {
+        std::cerr << "Usage --n=<n> --d=<d> [--key=HEX --iv=HEX] [--target=BITS] [--threads=T] "
+                     "[--starts=S] [--steps=STEPS]\n";
+        return 1;
+    }
+    const auto N = static_cast<uint64_t>(parser.get_value<int>("n"));
+    const auto D = static_cast<uint64_t>(parser.get_value<int>("d"));
+    const auto bits = parser.has_value("target") ? parser.get_value<int>("target") : 128;
+    const auto threads = parser.has_value("threads") ? parser.get_value<int>("threads") : 0;
+    const auto starts_cnt = parser.has_value("starts") ? parser.get_value<int>("starts") : 1;
+    const auto steps = parser.has_value("steps") ? parser.get_value<int>("steps") : 64;
+    if (bits <= 0 || threads < 0 || starts_cnt <= 0 || steps <= 0) {
+        std::cerr << "target, starts and steps have to be positive\n";
+        return 1;
+    }
+    const auto target_tvd = std::pow(2.0, -bits);
+
+    auto key = random_array<prng_t::key_type>(DummyPRNG{});
+    auto  iv = random_array<prng_t::iv_type>(DummyPRNG{});
+    if (parser.has_value("key") && parser.has_value("iv")) {
+        const auto& key_str = parser.get_value<std::string>("key");
+        const auto& iv_str = parser.get_value<std::string>("iv");
+        if (!is_hex(key_str) || !is_hex(iv_str)) {
+            std::cerr << "Key or iv is not a proper hexstring\n";
+            return 1;
+        }
+        key = hex_to_array<prng_t::key_type>(key_str);
+        iv = hex_to_array<prng_t::iv_type>(iv_str);
+    }
+
+    try {
+        const auto matrix = TransitionMatrix{
+            GraphBuilder<prng_t>::create_from_engine({key, iv}).build(N, D), static_cast<std::size_t>(threads)};
+
+        const auto lambda = second_eigenvalue(matrix);
+        std::cout << "N = " << N << "; D = " << D << '\n'
+                  << std::setprecision(12)
+                  << "second eigenvalue (upper bound): " << lambda << "; spectral gap: " << 1 - lambda << '\n'
+                  << "walk length for TVD <= 2^-" << bits << " (spectral bound): "
+                  << spectral_walk_length(N, lambda, target_tvd) << '\n';
+
+        // below that the distances are dominated by the rounding errors
+        const auto precision_floor = static_cast<double>(N) * 1e-15;
+        std::vector<double> worst(static_cast<std::size_t>(steps), 0.0);
+        for (int start = 0; start < starts_cnt && static_cast<uint64_t>(start) < N; ++start) {
+            const auto distances = total_variation(matrix, static_cast<point_t>(start), worst.size());
+            for (std::size_t t = 0; t < worst.size(); ++t) {
+                worst[t] = std::max(worst[t], distances[t]);
+            }
+        }
+
+        std::cout << std::setprecision(4) << "steps\tlog2(1/TVD)\n";
+        std::size_t measured = 0;
+        for (std::size_t t = 0; t < worst.size(); ++t) {
+            if (worst[t] <= precision_floor) {
+                std::cout << "(below the precision of doubles from here on)\n";
+                break;
+            }
+            std::cout << t + 1 << '\t' << -std::log2(worst[t]) << '\n';
+            if (worst[t] <= target_tvd && measured == 0) {
+                measured = t + 1;
+            }
+        }
+        if (measured) {
+            std::cout << "walk length for TVD <= 2^-" << bits << " (measured): " << measured << '\n';
+        }
+    } catch (const std::exception& exc) {
+        std::cerr << exc.what() << '\n';
+        return 1;
+    }
+}
@@ -5,6 +5,8 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
+#include <cstdint>
 #include <string>
 #include <utility>
 
@@ -12,6 +14,8 @@ namespace dfare {
 
 class Alphabet {
     std::string characters_;
+    // byte -> position in characters_, characters outside of the alphabet map to its size
+    std::array<uint16_t, 256> ords_ {};
 
  public:
     Alphabet() = default;
@@ -19,11 +23,15 @@ class Alphabet {
             characters_{std::move(characters)} {
         std::sort(characters_.begin(), characters_.end());
         characters_.erase(std::unique(characters_.begin(), characters_.end()), characters_.end());
+        build_ords();
     }
 
     bool add_character(char c);
 
-    size_t ord(char c) const;
+    size_t ord(char c) const noexcept {
+        return ords_[static_cast<unsigned char>(c)];
+    }
+
     char chr(std::size_t index) const;
 
     const std::string& characters() const;
@@ -40,6 +48,9 @@ class Alphabet {
 
     decltype(characters_.cbegin()) cbegin() const noexcept;
     decltype(characters_.cend()) cend() const noexcept;
+
+ private:
+    void build_ords() noexcept;
 };
 
 }  // namespace dfare
@@ -0,0 +1,71 @@
+/*
+ * author: Adam Budziak
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+
+#include <dfare/common/Alphabet.hpp>
+
+namespace dfare {
+
+/**
+ * Translation between the bytes of an alphabet and their positions (ranks) in it.
+ *
+ * For languages of single characters ranking a word is a static byte -> index mapping
+ * (Alphabet::ord), so whole strings are translated with one table read per character.
+ * The loops have no branches: invalid characters are accumulated and reported
+ * once at the end.
+ */
+class AlphabetCodec {
+    // byte -> rank, the bytes outside of the alphabet map to its size
+    Alphabet alphabet_;
+    // rank -> byte, the ranks past the size of the alphabet map to 0
+    std::array<char, 256> chars_ {};
+    std::size_t size_ = 0;
+
+ public:
+    explicit AlphabetCodec(const Alphabet& alphabet);
+
+    [[nodiscard]] std::size_t size() const noexcept { return size_; }
+
+    /**
+     * Writes the rank of every character of the text to `ranks`.
+     * Throws std::out_of_range if any of the characters isn't in the alphabet.
+     */
+    template <typename Rank_T>
+    void encode(std::string_view text, Rank_T* ranks) const {
+        bool invalid = false;
+        for (std::size_t i = 0; i < text.size(); ++i) {
+            const auto rank = alphabet_.ord(text[i]);
+            ranks[i] = static_cast<Rank_T>(rank);
+            invalid |= rank >= size_;
+        }
+        if (invalid) {
+            throw std::out_of_range("AlphabetCodec: character outside of the alphabet");
+        }
+    }
+
+    /**
+     * Writes the character of every one of `count` ranks to `text`.
+     * Throws std::out_of_range if any of the ranks isn't smaller than the size of the alphabet.
+     */
+    template <typename Rank_T>
+    void decode(const Rank_T* ranks, std::size_t count, char* text) const {
+        bool invalid = false;
+        for (std::size_t i = 0; i < count; ++i) {
+            text[i] = chars_[static_cast<uint8_t>(ranks[i])];
+            invalid |= static_cast<std::size_t>(ranks[i]) >= size_;
+        }
+        if (invalid) {
+            throw std::out_of_range("AlphabetCodec: rank outside of the alphabet");
+        }
+    }
+};
+
+}  // namespace dfare
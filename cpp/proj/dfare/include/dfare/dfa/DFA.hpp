@@ -4,10 +4,13 @@
 
 #pragma once
 
+#include <array>
+#include <cstdint>
 #include <map>
 #include <ostream>
 #include <set>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <utility>
 
@@ -16,11 +19,20 @@
 
 namespace dfare::dfa {
 
+/**
+ * Deterministic automaton built from a regexp, the last state is the dead one.
+ *
+ * Besides the edges given in the constructor, the automaton is kept in a compiled form
+ * used by all the queries: bytes with the same transitions from every state form
+ * an equivalence class, a 256-entry table maps bytes to their classes, and the transitions
+ * are a dense states x classes array (missing edges lead to the dead state).
+ */
 class DFA {
  public:
     using states_t = std::vector<regexp::regexp_ptr>;
     using edges_t  = std::map<uint64_t, std::map<char, uint64_t>>;
     using accept_states_t = std::vector<uint64_t>;
+    using class_t = uint16_t;
 
     const states_t states;
     const edges_t edges;
@@ -28,19 +40,98 @@ class DFA {
 
     const Alphabet alphabet;
 
+ private:
+    std::array<class_t, 256> m_byte_classes {};
+    std::size_t m_classes_cnt = 0;
+    std::vector<uint64_t> m_transitions;
+    std::vector<uint8_t> m_accepting;
+    std::size_t m_built_states_cnt;
+
+ public:
     DFA(states_t states, edges_t edges, accept_states_t accepting, Alphabet alphabet):
             states{std::move(states)}, edges{std::move(edges)},
-            accepting_states{std::move(accepting)}, alphabet{std::move(alphabet)} {  }
+            accepting_states{std::move(accepting)}, alphabet{std::move(alphabet)},
+            m_built_states_cnt{this->states.size()} {
+        compile();
+    }
+
+    /**
+     * Builds the automaton from the derivatives of the regexp, the start state is 0.
+     *
+     * The derivatives are computed by `threads` threads (all the hardware ones if 0),
+     * the states are numbered the same way regardless of it.
+     */
+    static DFA from_regex(const regexp::regexp_ptr& regex, bool minimize = false, std::size_t threads = 0);
+
+    /**
+     * The equivalent DFA with the least number of states (Moore's algorithm).
+     *
+     * The states are numbered in BFS order from the start state, with the dead state last,
+     * and each of them keeps the regexp of one of the merged states.
+     * Unreachable states are dropped.
+     */
+    DFA minimized() const;
 
-    static DFA from_regex(const regexp::regexp_ptr& regex);
+    /**
+     * Minimal DFA accepting the words accepted by both automata.
+     *
+     * The result of this and the other operations below works over the union
+     * of the alphabets. Its states are pairs of the states of the operands,
+     * so none of them has a regexp: every state holds the Empty regexp.
+     */
+    DFA intersected(const DFA& other) const;
 
-    uint64_t run(const std::string& input) const;
-    bool accepts(const std::string& input) const;
+    /**
+     * Minimal DFA accepting the words accepted by any of the automata.
+     */
+    DFA united(const DFA& other) const;
+
+    /**
+     * Minimal DFA accepting the words over the alphabet of this one that it doesn't accept.
+     */
+    DFA complemented() const;
+
+    /**
+     * Number of states the automaton was built with, before it was minimized.
+     */
+    std::size_t built_states_count() const noexcept { return m_built_states_cnt; }
+
+    uint64_t run(std::string_view input) const;
+    bool accepts(std::string_view input) const;
     bool has_transition(uint64_t from, char label) const;
     uint64_t get_transition(uint64_t from, char label) const;
 
+    uint64_t dead_state() const noexcept { return states.size() - 1; }
+
+    bool is_accepting(uint64_t state) const noexcept { return m_accepting[state]; }
+
+    class_t byte_class(char c) const noexcept { return m_byte_classes[static_cast<unsigned char>(c)]; }
+
+    std::size_t classes_count() const noexcept { return m_classes_cnt; }
+
+    /**
+     * Transition on the class of bytes, without bounds checking.
+     */
+    uint64_t class_transition(uint64_t from, class_t cls) const noexcept {
+        return m_transitions[from * m_classes_cnt + cls];
+    }
+
 
     friend std::ostream& operator<<(std::ostream&, const DFA&);
+
+ private:
+    friend class RankedDFA;
+
+    /**
+     * The automaton given directly in its compiled form (e.g. loaded from a cache).
+     * The regexps of the states aren't known, every state holds the Empty regexp.
+     */
+    DFA(Alphabet alphabet, const std::array<class_t, 256>& byte_classes, std::size_t classes_cnt,
+        std::vector<uint64_t> transitions, std::vector<uint8_t> accepting, std::size_t built_states_cnt);
+
+    void compile();
+
+    DFA product(const DFA& other, bool (*accept)(bool, bool)) const;
 };
 
 std::ostream& operator<<(std::ostream& os, const DFA::states_t& states);
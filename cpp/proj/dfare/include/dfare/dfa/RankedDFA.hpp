@@ -4,48 +4,163 @@
 
 #pragma once
 
-#include <map>
+#include <memory>
 #include <string>
+#include <string_view>
 #include <utility>
+#include <vector>
 
 #include <dfare/regexp/from_string.hpp>
+#include <pur/containers/array_view.hpp>
 #include <pur/optional/Optional.hpp>
 #include "DFA.hpp"
 
 namespace dfare::dfa {
 
+/**
+ * DFA ranking words of a fixed length.
+ *
+ * The rank table holds, for every length l <= n and every state q, the number of words
+ * of length l accepted from q. It is a dense (n + 1) x states array built once
+ * in the constructor, so all the queries are const and can be run concurrently.
+ *
+ * Additionally, for every remaining length l < n, state q and the j-th character of the alphabet
+ * the prefix table holds the number of accepted words starting from q that continue
+ * with a character smaller than the j-th one and have l more characters after it.
+ * Thanks to that ranking costs one table read per character and unranking
+ * a binary search per character.
+ *
+ * The tables are immutable and shared between the copies, so copying is cheap.
+ * A compiled RankedDFA can be saved to a binary file and mapped back from it
+ * (see from_string_cached), in which case the tables are read straight from the mapping.
+ */
 class RankedDFA {
-    using table_t = std::map<std::pair<uint64_t, uint64_t>, uint64_t>;
+    using table_t = std::vector<uint64_t>;
+
+    static constexpr std::size_t MIN_STATES_PER_THREAD = 4096;
+    static constexpr std::size_t GROUP_SIZE = 8;
+
+    struct tables_t {
+        const uint64_t* rank;
+        const uint64_t* prefix;
+        // owns the memory of both tables: vectors or a mapped file
+        std::shared_ptr<const void> storage;
+    };
 
  public:
     const DFA dfa;
     const size_t n;
 
  private:
-    mutable table_t rank_table;
+    const tables_t tables;
 
  public:
     const size_t max_rank;
     explicit RankedDFA(DFA dfa, size_t word_length):
             dfa {std::move(dfa)},
             n{word_length},
-            rank_table{build_table(word_length)},
+            tables{build_tables()},
             max_rank {compute_max_rank()} {
     }
 
+    /**
+     * Builds the minimal DFA of the regexp and ranks its words of the given length.
+     */
     static RankedDFA from_string(const std::string& str, std::size_t word_length) {
-        return RankedDFA {DFA::from_regex(regexp::from_string(str)),  word_length};
+        return RankedDFA {DFA::from_regex(regexp::from_string(str), true),  word_length};
+    }
+
+    /**
+     * Same as from_string, but the compiled DFA is kept in the cache file:
+     * it is mapped from there if the file was made for the same regexp and word length,
+     * otherwise it is built and the file is (re)written. Failing to write the file
+     * (e.g. in a read-only directory) isn't an error.
+     */
+    static RankedDFA from_string_cached(const std::string& str, std::size_t word_length,
+                                        const std::string& cache_path);
+
+    /**
+     * FNV-1a hash of the regexp and the word length, identifying the cache files made for them.
+     */
+    static uint64_t content_hash(const std::string& str, std::size_t word_length) noexcept;
+
+    /**
+     * Writes the compiled DFA (alphabet, byte classes, transitions, accepting states,
+     * word length and the tables) to the file, atomically replacing it.
+     * The regexps of the states aren't saved.
+     */
+    void save(const std::string& path, uint64_t hash) const;
+
+    /**
+     * Maps the compiled DFA saved in the file, dfare::invalid_dfa_cache is thrown
+     * if it isn't a valid cache file or was saved with another hash.
+     */
+    static RankedDFA load(const std::string& path, uint64_t hash);
+
+    [[nodiscard]] bool accepts(std::string_view input) const noexcept;
+
+    /**
+     * The rank table, row-major: count(state, length) is at [length * states + state].
+     */
+    [[nodiscard]] pur::array_view<uint64_t> get_rank_table() const noexcept {
+        return {tables.rank, (n + 1) * dfa.states.size()};
     }
 
-    [[nodiscard]] bool accepts(const std::string& input) const noexcept;
+    /**
+     * Number of words of the given length accepted starting from the state.
+     */
+    [[nodiscard]] uint64_t count(uint64_t state, std::size_t length) const noexcept {
+        return tables.rank[length * dfa.states.size() + state];
+    }
 
-    [[nodiscard]] const table_t& get_rank_table() const noexcept { return rank_table; }
+    std::size_t rank(std::string_view word) const;
+
+    /**
+     * The rank of the single-character word, the same as rank(std::string_view{&chr, 1}).
+     */
+    std::size_t rank(char chr) const {
+        return rank(std::string_view{&chr, 1});
+    }
 
-    std::size_t rank(const std::string& regex) const;
     std::string unrank(std::size_t rank) const;
 
+    /**
+     * Writes the word of the given rank (exactly n characters) to the caller's buffer.
+     */
+    void unrank(std::size_t rank, char* word) const;
+
+    /**
+     * Ranks `count` words at once, the same as calling rank for each of them.
+     *
+     * Words are processed in interleaved groups, so the table reads of different words
+     * (which don't depend on each other) overlap instead of waiting one for another.
+     */
+    void rank_many(const std::string_view* words, std::size_t count, uint64_t* ranks) const;
+    std::vector<uint64_t> rank_many(const std::vector<std::string_view>& words) const;
+
+    /**
+     * Unranks `count` ranks at once into a single buffer of count * n characters,
+     * the i-th word is at [i * n, (i + 1) * n).
+     */
+    void unrank_many(const uint64_t* ranks, std::size_t count, char* words) const;
+    std::string unrank_many(const std::vector<uint64_t>& ranks) const;
+
  private:
+    RankedDFA(DFA dfa, size_t word_length, tables_t tables):
+            dfa {std::move(dfa)},
+            n{word_length},
+            tables{std::move(tables)},
+            max_rank {compute_max_rank()} {
+    }
+
+    tables_t build_tables() const;
     table_t build_table(std::size_t word_length) const;
+    table_t build_prefix_table(const table_t& rank_table) const;
+
+    const uint64_t* prefix_row(uint64_t state, std::size_t length) const noexcept {
+        const auto row_size = dfa.alphabet.characters().size() + 1;
+        return tables.prefix + (length * dfa.states.size() + state) * row_size;
+    }
     size_t compute_max_rank() const;
 };
 
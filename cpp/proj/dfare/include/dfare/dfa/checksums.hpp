@@ -0,0 +1,30 @@
+/*
+ * author: Adam Budziak
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include "DFA.hpp"
+
+/**
+ * Automata of common check-digit schemes over the decimal digits.
+ *
+ * They accept numbers of any length, so to get a fixed format
+ * (e.g. 16-digit card numbers with a valid check digit) intersect them
+ * with the automaton of the format.
+ */
+namespace dfare::dfa::checksums {
+
+/**
+ * Numbers passing the Luhn (mod 10) check, i.e. card numbers and IMEIs.
+ */
+DFA luhn();
+
+/**
+ * Numbers whose value is congruent to the residue modulo the modulus.
+ */
+DFA mod(uint64_t modulus, uint64_t residue = 0);
+
+}  // namespace dfare::dfa::checksums
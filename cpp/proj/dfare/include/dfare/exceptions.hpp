@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <stdexcept>
 #include <string>
 #include <utility>
 
@@ -21,4 +22,10 @@ class invalid_regexp_string : public std::exception {
     }
 };
 
+class invalid_dfa_cache : public std::runtime_error {
+ public:
+    explicit invalid_dfa_cache(const std::string& reason)
+    : std::runtime_error { "Invalid compiled DFA cache: " + reason } {  }
+};
+
 }  // namespace dfare
@@ -13,7 +13,11 @@ namespace dfare::regexp {
 
 class Closure: public RegExpBase_<Closure> {
  public:
-    explicit Closure(regexp_ptr value): value{std::move(value)} {  }
+    static constexpr int KIND = 3;
+
+    explicit Closure(regexp_ptr value): value{std::move(value)} {
+        set_hash(combine_hash(hash(), this->value->hash()));
+    }
     const regexp_ptr value;
 
     explicit operator std::string() const override;
@@ -21,6 +25,7 @@ class Closure: public RegExpBase_<Closure> {
     bool matches_empty() const override;
 
     bool operator==(const Closure& other) const;
+    int compare_to(const Closure& other) const;
     static regexp_ptr create(regexp_ptr value);
 };
 
@@ -13,9 +13,13 @@ namespace dfare::regexp {
 
 class Concat: public RegExpBase_<Concat> {
  public:
+    static constexpr int KIND = 4;
+
     const regexp_ptr left, right;
     Concat(regexp_ptr left, regexp_ptr right)
-            : left {std::move(left)}, right {std::move(right)} {  }
+            : left {std::move(left)}, right {std::move(right)} {
+        set_hash(combine_hash(combine_hash(hash(), this->left->hash()), this->right->hash()));
+    }
 
     bool matches_empty() const override;
 
@@ -24,6 +28,7 @@ class Concat: public RegExpBase_<Concat> {
     regexp_ptr derivative(char prefix) const override;
 
     bool operator==(const Concat& other) const;
+    int compare_to(const Concat& other) const;
 
     static regexp_ptr create(regexp_ptr left, regexp_ptr right);
 
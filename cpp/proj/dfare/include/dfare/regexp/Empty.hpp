@@ -12,6 +12,18 @@ namespace dfare::regexp {
 
 class Empty: public RegExpBase_<Empty> {
  public:
+    static constexpr int KIND = 0;
+
+    Empty() = default;
+
+    /**
+     * There is only one Empty node.
+     */
+    static regexp_ptr create() {
+        static const regexp_ptr instance = RegExpBase_<Empty>::create();
+        return instance;
+    }
+
     explicit operator std::string() const override {
         return "Null";
     }
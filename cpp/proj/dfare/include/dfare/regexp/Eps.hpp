@@ -13,6 +13,18 @@ namespace dfare::regexp {
 
 class Eps: public RegExpBase_<Eps> {
  public:
+    static constexpr int KIND = 1;
+
+    Eps() = default;
+
+    /**
+     * There is only one Eps node.
+     */
+    static regexp_ptr create() {
+        static const regexp_ptr instance = RegExpBase_<Eps>::create();
+        return instance;
+    }
+
     explicit operator std::string() const override {
         return "eps";
     }
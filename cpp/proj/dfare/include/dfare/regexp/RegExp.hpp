@@ -18,13 +18,18 @@ class RegExp : public RegExpBase_<RegExp> {
     char value;
 
  public:
+    static constexpr int KIND = 2;
+
     bool matches_empty() const override;
 
-    explicit RegExp(char value): value {value} {}
+    explicit RegExp(char value): value {value} {
+        set_hash(combine_hash(hash(), static_cast<unsigned char>(value)));
+    }
     explicit operator std::string() const override;
 
     regexp_ptr derivative(char prefix) const override;
     bool operator==(const RegExp& other) const;
+    int compare_to(const RegExp& other) const;
 };
 
 }  // namespace dfare::regexp
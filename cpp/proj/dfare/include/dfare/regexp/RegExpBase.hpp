@@ -4,10 +4,14 @@
 
 #pragma once
 
+#include <cstddef>
 #include <memory>
+#include <new>
 #include <string>
 #include <utility>
 
+#include "arena_scope.hpp"
+
 namespace dfare::regexp {
 
 class RegExpBase;
@@ -64,8 +68,36 @@ class regexp_ptr {
 
 std::ostream& operator<<(std::ostream& os, const regexp_ptr& p);
 
+namespace detail {
+
+/**
+ * Returns the living node structurally equal to the given one if there is one,
+ * otherwise registers the given node. Takes the ownership of the node,
+ * which lives in the arena if one is given and on the heap otherwise.
+ */
+regexp_ptr intern(const RegExpBase* node, std::shared_ptr<pur::arena> arena);
+
+/**
+ * Like intern for a node allocated on the heap, except that the node replaces
+ * an equal living node allocated in an arena (see detach_from_arenas).
+ */
+regexp_ptr intern_on_heap(const RegExpBase* node);
+
+bool in_arena(const regexp_ptr& regex);
 
-class RegExpBase {
+}  // namespace detail
+
+
+/**
+ * Base of all the regexp nodes.
+ *
+ * Nodes created with `create` are hash-consed: there is at most one living node
+ * of every structure, so structurally equal nodes are pointer-equal and can be
+ * compared or looked up by their addresses. Together with the canonical forms
+ * produced by `create` (e.g. sorted operands of sums) this makes equivalent
+ * derivatives the same object.
+ */
+class RegExpBase : public std::enable_shared_from_this<RegExpBase> {
  public:
     virtual ~RegExpBase() = default;
     virtual explicit operator std::string() const = 0;
@@ -74,15 +106,36 @@ class RegExpBase {
     virtual bool matches_empty() const = 0;
 
     bool operator==(const RegExpBase& other) const {
-        return equals(other);
+        return this == &other || (hash_ == other.hash_ && equals(other));
     }
     bool equivalent(const RegExpBase& other) const {
         return equivalent_(other);
     }
 
+    /**
+     * Structural hash, equal for equal nodes.
+     */
+    std::size_t hash() const noexcept { return hash_; }
+
+    /**
+     * Total structural order of the nodes: negative, zero or positive like std::string::compare.
+     */
+    int compare(const RegExpBase& other) const;
+
  protected:
     virtual bool equals(const RegExpBase& other) const = 0;
     virtual bool equivalent_(const RegExpBase& other) const = 0;
+    virtual int kind() const noexcept = 0;
+    virtual int compare_same_kind(const RegExpBase& other) const = 0;
+
+    void set_hash(std::size_t value) noexcept { hash_ = value; }
+
+    static std::size_t combine_hash(std::size_t seed, std::size_t value) noexcept {
+        return seed ^ (value + 0x9e3779b97f4a7c15ULL + (seed << 6u) + (seed >> 2u));
+    }
+
+ private:
+    std::size_t hash_ = 0;
 };
 
 
@@ -91,10 +144,22 @@ class RegExpBase_ : public RegExpBase {
  public:
     template<typename ...Args>
     static regexp_ptr create(Args... args) {
-        return regexp_ptr{std::make_shared<Derived>(std::forward<Args>(args)...)};
+        if (const auto& arena = detail::current_arena()) {
+            void* memory = arena->allocate(sizeof(Derived), alignof(Derived));
+            return detail::intern(new (memory) Derived(std::forward<Args>(args)...), arena);
+        }
+        return detail::intern(new Derived(std::forward<Args>(args)...), nullptr);
     }
 
  protected:
+    int kind() const noexcept override {
+        return Derived::KIND;
+    }
+
+    int compare_same_kind(const RegExpBase& o) const override {
+        return static_cast<const Derived&>(*this).compare_to(static_cast<const Derived&>(o));
+    }
+
     bool equals(const RegExpBase& o) const override {
         auto other = dynamic_cast<const Derived*>(&o);
         return other != nullptr && static_cast<const Derived&>(*this) == *other;
@@ -113,7 +178,14 @@ class RegExpBase_ : public RegExpBase {
     constexpr bool operator==(const RegExpBase_&) const {
         return false;
     }
-    RegExpBase_() = default;
+
+    constexpr int compare_to(const Derived&) const {
+        return 0;
+    }
+
+    RegExpBase_() {
+        set_hash(std::hash<int>{}(Derived::KIND));
+    }
     friend Derived;
 };
 
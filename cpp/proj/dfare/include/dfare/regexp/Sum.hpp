@@ -14,9 +14,13 @@ namespace dfare::regexp {
 
 class Sum : public RegExpBase_<Sum> {
  public:
+    static constexpr int KIND = 5;
+
     const regexp_ptr left, right;
     Sum(regexp_ptr left, regexp_ptr right):
-            left {std::move(left)}, right {std::move(right)} {}
+            left {std::move(left)}, right {std::move(right)} {
+        set_hash(combine_hash(combine_hash(hash(), this->left->hash()), this->right->hash()));
+    }
 
     explicit operator std::string() const override;
 
@@ -25,9 +29,15 @@ class Sum : public RegExpBase_<Sum> {
     bool matches_empty() const override;
 
     bool operator==(const Sum& other) const;
+    int compare_to(const Sum& other) const;
 
     bool equivalent(const Sum &other) const;
 
+    /**
+     * Creates the sum in the canonical form: nested sums are flattened, the operands
+     * are sorted (see RegExpBase::compare), duplicates and Empty are removed, and the result
+     * is nested to the right, e.g. c + (b + a) becomes (a + (b + c)).
+     */
     static regexp_ptr create(regexp_ptr left, regexp_ptr right);
 };
 
@@ -0,0 +1,63 @@
+/*
+ * author: Adam Budziak
+ */
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <pur/memory/arena.hpp>
+
+namespace dfare::regexp {
+
+class regexp_ptr;
+
+/**
+ * While the scope is alive, regexp nodes created on the current thread are allocated
+ * (together with their reference counts) in its arena instead of separately on the heap.
+ * Deallocating them costs nothing; the arena is freed when both the scope
+ * and all the nodes allocated in it are gone.
+ *
+ * Meant for short, allocation-heavy phases like building a DFA, which create
+ * many nodes and discard almost all of them. Scopes can be nested.
+ */
+class arena_scope {
+    std::shared_ptr<pur::arena> m_arena;
+    std::shared_ptr<pur::arena> m_previous;
+
+ public:
+    arena_scope();
+
+    /**
+     * Scope allocating in an existing arena, e.g. one reused by a worker thread
+     * across several phases. The arena mustn't be used by two threads at once.
+     */
+    explicit arena_scope(std::shared_ptr<pur::arena> arena);
+    ~arena_scope();
+
+    arena_scope(const arena_scope&) = delete;
+    arena_scope& operator=(const arena_scope&) = delete;
+
+    const pur::arena& arena() const noexcept { return *m_arena; }
+};
+
+/**
+ * Moves the regexps (with all their subexpressions) living in arenas to the heap,
+ * so that keeping them doesn't keep whole arenas alive. The heap copies take the place
+ * of the originals in the hash-consing; the nodes outside of the arenas are kept as they are.
+ *
+ * Meant for the few results of an arena phase which outlive it, once the phase is over.
+ */
+void detach_from_arenas(std::vector<regexp_ptr>& regexps);
+
+namespace detail {
+
+/**
+ * The arena of the innermost scope alive on the current thread, nullptr if there is none.
+ */
+const std::shared_ptr<pur::arena>& current_arena() noexcept;
+
+}  // namespace detail
+
+}  // namespace dfare::regexp
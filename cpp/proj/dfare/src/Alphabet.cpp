@@ -8,11 +8,6 @@
 
 namespace dfare {
 
-size_t Alphabet::ord(char c) const {
-    auto iter = std::find(begin(), end(), c);
-    return static_cast<size_t>(iter - begin());
-}
-
 char Alphabet::chr(std::size_t index) const {
     return characters_.at(index);
 }
@@ -21,9 +16,17 @@ bool Alphabet::add_character(char c) {
     auto pos = std::lower_bound(characters_.begin(), characters_.end(), c);
     if (pos != characters_.end() && *pos == c) { return false; }
     characters_.insert(pos, c);
+    build_ords();
     return true;
 }
 
+void Alphabet::build_ords() noexcept {
+    ords_.fill(static_cast<uint16_t>(characters_.size()));
+    for (size_t i = 0; i < characters_.size(); ++i) {
+        ords_[static_cast<unsigned char>(characters_[i])] = static_cast<uint16_t>(i);
+    }
+}
+
 const std::string &Alphabet::characters() const {
     return characters_;
 }
@@ -0,0 +1,16 @@
+/*
+ * author: Adam Budziak
+ */
+
+#include <dfare/common/AlphabetCodec.hpp>
+
+namespace dfare {
+
+AlphabetCodec::AlphabetCodec(const Alphabet& alphabet)
+  : alphabet_ {alphabet}, size_ {alphabet.characters().size()} {
+    for (std::size_t i = 0; i < size_; ++i) {
+        chars_[i] = alphabet.chr(i);
+    }
+}
+
+}  // namespace dfare
@@ -34,6 +34,10 @@ bool Closure::operator==(const Closure& other) const {
     return value == other.value;
 }
 
+int Closure::compare_to(const Closure &other) const {
+    return value->compare(*other.value);
+}
+
 
 regexp_ptr Closure::create(regexp_ptr value) {
     if (dynamic_cast<const Closure*>(value.get())) { return value; }
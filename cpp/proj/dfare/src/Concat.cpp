@@ -28,6 +28,11 @@ bool Concat::operator==(const Concat &other) const {
     return left == other.left && right == other.right;
 }
 
+int Concat::compare_to(const Concat &other) const {
+    auto result = left->compare(*other.left);
+    return result != 0 ? result : right->compare(*other.right);
+}
+
 regexp_ptr Concat::create(regexp_ptr left, regexp_ptr right) {
     if (dynamic_cast<const Empty*>(left.get())) return left;
     if (dynamic_cast<const Empty*>(right.get())) return right;
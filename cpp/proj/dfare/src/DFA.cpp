@@ -6,44 +6,87 @@
 #include <iostream>
 #include <algorithm>
 #include <sstream>
+#include <thread>
 #include <functional>
+#include <unordered_map>
 
 #include <pur/logger/stream_operators.hpp>
 #include <dfare/dfa/DFA.hpp>
+#include <dfare/regexp/Empty.hpp>
 #include <dfare/regexp/Eps.hpp>
+#include <dfare/regexp/arena_scope.hpp>
 #include <dfare/regexp/from_string.hpp>
 #include <dfare/regexp/RegExpBase.hpp>
 
 namespace dfare::dfa {
 
-struct recursively_build {
+/**
+ * Builds the states layer by layer: the derivatives of the whole frontier are computed
+ * in parallel, then merged in (state, character) order, so the numbering doesn't depend
+ * on the number of threads.
+ */
+struct worklist_build {
+    static constexpr std::size_t MIN_DERIVATIVES_PER_THREAD = 256;
+
     DFA::states_t& states;
     DFA::edges_t& edges;
     const Alphabet& alphabet;
+    std::size_t threads_cnt;
+    // regexps are hash-consed, so equivalent derivatives are the same node
+    std::unordered_map<const regexp::RegExpBase*, uint64_t> indices {{states.front().get(), 0}};
+    // arena scopes are per thread; every worker keeps its arena for the whole build
+    std::vector<std::shared_ptr<pur::arena>> arenas;
 
-    auto find_equivalent(const regexp::regexp_ptr& deriv) {
-        auto equiv = [&deriv](const auto& other) { return deriv.equivalent(other); };
-        return std::find_if(states.begin(), states.end(), equiv);
-    }
+    void operator()() {
+        const auto& characters = alphabet.characters();
+        const auto chars_cnt = characters.size();
+        std::vector<regexp::regexp_ptr> derivatives;
 
-    void operator()(const regexp::regexp_ptr& regex) {
-        auto current_index = states.size()-1;
+        for (std::size_t frontier = 0; frontier < states.size();) {
+            const auto frontier_end = states.size();
+            const auto jobs = (frontier_end - frontier) * chars_cnt;
+            derivatives.assign(jobs, regexp::regexp_ptr{});
 
-        for (char c : alphabet.characters()) {
-            auto deriv = regex.derivative(c);
-            if (auto equiv = find_equivalent(deriv); equiv != states.end()) {
-                edges[current_index][c] = static_cast<std::size_t>(equiv - states.begin());
-            } else {
-                states.push_back(deriv);
-                edges[current_index][c] = states.size() - 1;
-                (*this)(deriv);
+            // the states are only read until all the workers are joined
+            const auto derive = [&](std::size_t first, std::size_t last) {
+                for (auto job = first; job < last; ++job) {
+                    derivatives[job] = states[frontier + job / chars_cnt].derivative(characters[job % chars_cnt]);
+                }
+            };
+
+            const auto workers_cnt = std::max<std::size_t>(1, std::min(threads_cnt, jobs / MIN_DERIVATIVES_PER_THREAD));
+            const auto chunk = jobs / workers_cnt;
+            while (arenas.size() < workers_cnt) {
+                arenas.push_back(std::make_shared<pur::arena>());
             }
+            const auto derive_in_arena = [this, &derive](std::size_t worker, std::size_t first, std::size_t last) {
+                regexp::arena_scope arena {arenas[worker]};
+                derive(first, last);
+            };
+            std::vector<std::thread> workers;
+            for (std::size_t i = 1; i < workers_cnt; ++i) {
+                workers.emplace_back(derive_in_arena, i, i * chunk, i + 1 == workers_cnt ? jobs : (i + 1) * chunk);
+            }
+            derive_in_arena(0, 0, workers_cnt > 1 ? chunk : jobs);
+            for (auto& worker : workers) {
+                worker.join();
+            }
+
+            for (std::size_t job = 0; job < jobs; ++job) {
+                auto& deriv = derivatives[job];
+                auto [equiv, inserted] = indices.emplace(deriv.get(), states.size());
+                if (inserted) {
+                    states.push_back(std::move(deriv));
+                }
+                edges[frontier + job / chars_cnt][characters[job % chars_cnt]] = equiv->second;
+            }
+            frontier = frontier_end;
         }
     }
 };
 
 
-DFA DFA::from_regex(const regexp::regexp_ptr& regex) {
+DFA DFA::from_regex(const regexp::regexp_ptr& regex, bool minimize, std::size_t threads) {
     std::ostringstream oss;
     oss << regex;
     auto alphabet = regexp::get_alphabet(oss.str());
@@ -51,14 +94,93 @@ DFA DFA::from_regex(const regexp::regexp_ptr& regex) {
     DFA::edges_t edges {};
     DFA::accept_states_t accepting {};
 
-    recursively_build {states, edges, alphabet}(regex);
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    // almost all the derivatives are discarded right away, so they are allocated in arenas
+    worklist_build {states, edges, alphabet, threads}();
+    // the arenas are freed together with the rest of the derivatives, not kept by the states
+    regexp::detach_from_arenas(states);
 
     for (uint64_t index = 0; index < states.size(); ++index) {
         if (states[index].matches_empty()) accepting.push_back(index);
     }
 
     states.push_back(regexp::Empty::create());
-    return {states, edges, accepting, alphabet};
+    DFA dfa {states, edges, accepting, alphabet};
+    return minimize ? dfa.minimized() : dfa;
+}
+
+
+DFA DFA::minimized() const {
+    const auto states_cnt = states.size();
+
+    std::vector<class_t> symbols;
+    for (char c : alphabet.characters()) {
+        symbols.push_back(byte_class(c));
+    }
+    std::sort(symbols.begin(), symbols.end());
+    symbols.erase(std::unique(symbols.begin(), symbols.end()), symbols.end());
+
+    // Moore's refinement: states stay in one block as long as their successors do
+    std::vector<uint64_t> block(states_cnt);
+    for (uint64_t state = 0; state < states_cnt; ++state) {
+        block[state] = is_accepting(state);
+    }
+    std::size_t blocks_cnt = std::set<uint64_t>(block.begin(), block.end()).size();
+
+    while (true) {
+        std::map<std::vector<uint64_t>, uint64_t> signatures;
+        std::vector<uint64_t> refined(states_cnt);
+        for (uint64_t state = 0; state < states_cnt; ++state) {
+            std::vector<uint64_t> signature {block[state]};
+            for (auto cls : symbols) {
+                signature.push_back(block[class_transition(state, cls)]);
+            }
+            refined[state] = signatures.emplace(std::move(signature), signatures.size()).first->second;
+        }
+        if (signatures.size() == blocks_cnt) { break; }
+        blocks_cnt = signatures.size();
+        block = std::move(refined);
+    }
+
+    // BFS numbering of the reachable blocks, the dead one goes last
+    const auto dead_block = block[dead_state()];
+    std::vector<uint64_t> representative;
+    std::map<uint64_t, uint64_t> numbering;
+    if (block[0] != dead_block) {
+        numbering[block[0]] = 0;
+        representative.push_back(0);
+    }
+    for (std::size_t i = 0; i < representative.size(); ++i) {
+        for (auto cls : symbols) {
+            auto next = class_transition(representative[i], cls);
+            if (block[next] != dead_block && numbering.emplace(block[next], representative.size()).second) {
+                representative.push_back(next);
+            }
+        }
+    }
+
+    states_t min_states;
+    edges_t min_edges;
+    accept_states_t min_accepting;
+    for (uint64_t state = 0; state < representative.size(); ++state) {
+        min_states.push_back(states[representative[state]]);
+        if (is_accepting(representative[state])) {
+            min_accepting.push_back(state);
+        }
+        for (char c : alphabet.characters()) {
+            auto next = block[get_transition(representative[state], c)];
+            if (next != dead_block) {
+                min_edges[state][c] = numbering.at(next);
+            }
+        }
+    }
+    min_states.push_back(states[dead_state()]);
+
+    DFA result {min_states, min_edges, min_accepting, alphabet};
+    result.m_built_states_cnt = m_built_states_cnt;
+    return result;
 }
 
 
@@ -72,33 +194,153 @@ std::ostream& operator<<(std::ostream& os, const DFA& dfa) {
 }
 
 
-uint64_t DFA::run(const std::string &input) const {
+DFA DFA::intersected(const DFA& other) const {
+    return product(other, [](bool lhs, bool rhs) { return lhs && rhs; });
+}
+
+
+DFA DFA::united(const DFA& other) const {
+    return product(other, [](bool lhs, bool rhs) { return lhs || rhs; });
+}
+
+
+DFA DFA::complemented() const {
+    // the product with itself just makes every transition explicit, dead states included
+    return product(*this, [](bool lhs, bool) { return !lhs; });
+}
+
+
+DFA DFA::product(const DFA& other, bool (*accept)(bool, bool)) const {
+    const Alphabet product_alphabet {alphabet.characters() + other.alphabet.characters()};
+
+    // BFS over the reachable pairs, the dead state of the product is appended after them
+    std::vector<std::pair<uint64_t, uint64_t>> pairs {{0, 0}};
+    std::map<std::pair<uint64_t, uint64_t>, uint64_t> numbering {{pairs.front(), 0}};
+    edges_t product_edges;
+    accept_states_t product_accepting;
+    for (uint64_t state = 0; state < pairs.size(); ++state) {
+        const auto [lhs, rhs] = pairs[state];
+        if (accept(is_accepting(lhs), other.is_accepting(rhs))) {
+            product_accepting.push_back(state);
+        }
+        for (char c : product_alphabet.characters()) {
+            auto next = std::make_pair(get_transition(lhs, c), other.get_transition(rhs, c));
+            auto [equiv, inserted] = numbering.emplace(next, pairs.size());
+            if (inserted) {
+                pairs.push_back(next);
+            }
+            product_edges[state][c] = equiv->second;
+        }
+    }
+
+    states_t product_states(pairs.size() + 1, regexp::Empty::create());
+    DFA result {std::move(product_states), std::move(product_edges), std::move(product_accepting), product_alphabet};
+    // pairs which can't lead to acceptance are merged into the dead state here
+    return result.minimized();
+}
+
+
+namespace {
+
+DFA::edges_t edges_of(const Alphabet& alphabet, const std::array<DFA::class_t, 256>& byte_classes,
+                      std::size_t classes_cnt, const std::vector<uint64_t>& transitions) {
+    const auto states_cnt = transitions.size() / classes_cnt;
+    DFA::edges_t edges;
+    // the dead state is the last one, and no edges lead to it
+    for (uint64_t state = 0; state + 1 < states_cnt; ++state) {
+        for (char c : alphabet.characters()) {
+            auto next = transitions[state * classes_cnt + byte_classes[static_cast<unsigned char>(c)]];
+            if (next + 1 != states_cnt) {
+                edges[state][c] = next;
+            }
+        }
+    }
+    return edges;
+}
+
+DFA::accept_states_t accepting_states_of(const std::vector<uint8_t>& accepting) {
+    DFA::accept_states_t states;
+    for (uint64_t state = 0; state < accepting.size(); ++state) {
+        if (accepting[state]) { states.push_back(state); }
+    }
+    return states;
+}
+
+}  // namespace
+
+
+DFA::DFA(Alphabet alphabet, const std::array<class_t, 256>& byte_classes, std::size_t classes_cnt,
+         std::vector<uint64_t> transitions, std::vector<uint8_t> accepting, std::size_t built_states_cnt):
+        states(accepting.size(), regexp::Empty::create()),
+        edges{edges_of(alphabet, byte_classes, classes_cnt, transitions)},
+        accepting_states{accepting_states_of(accepting)},
+        alphabet{std::move(alphabet)},
+        m_byte_classes{byte_classes},
+        m_classes_cnt{classes_cnt},
+        m_transitions{std::move(transitions)},
+        m_accepting{std::move(accepting)},
+        m_built_states_cnt{built_states_cnt} {
+}
+
+
+void DFA::compile() {
+    const auto states_cnt = states.size();
+    const auto dead = dead_state();
+
+    // the column of a byte holds its transitions from all the states
+    std::map<std::vector<uint64_t>, class_t> classes;
+    std::vector<std::vector<uint64_t>> columns;
+    for (int byte = 0; byte < 256; ++byte) {
+        auto chr = static_cast<char>(byte);
+        std::vector<uint64_t> column(states_cnt, dead);
+        for (auto& [from, labels] : edges) {
+            if (auto edge = labels.find(chr); edge != labels.end()) {
+                column[from] = edge->second;
+            }
+        }
+        auto [cls, inserted] = classes.emplace(column, static_cast<class_t>(classes.size()));
+        if (inserted) {
+            columns.push_back(std::move(column));
+        }
+        m_byte_classes[byte] = cls->second;
+    }
+
+    m_classes_cnt = columns.size();
+    m_transitions.resize(states_cnt * m_classes_cnt);
+    for (std::size_t cls = 0; cls < m_classes_cnt; ++cls) {
+        for (std::size_t state = 0; state < states_cnt; ++state) {
+            m_transitions[state * m_classes_cnt + cls] = columns[cls][state];
+        }
+    }
+
+    m_accepting.assign(states_cnt, 0);
+    for (auto state : accepting_states) {
+        m_accepting[state] = 1;
+    }
+}
+
+
+uint64_t DFA::run(std::string_view input) const {
     uint64_t q = 0;
     for (char c : input) {
-        if (edges.count(q) == 0 || edges.at(q).count(c) == 0) {
-            return states.size() - 1;
-        }
-        q = edges.at(q).at(c);
+        q = class_transition(q, byte_class(c));
     }
     return q;
 }
 
 
-bool DFA::accepts(const std::string &input) const {
-    auto result_state = run(input);
-    return std::find(
-            accepting_states.begin(),
-            accepting_states.end(), result_state) != accepting_states.end();
+bool DFA::accepts(std::string_view input) const {
+    return is_accepting(run(input));
 }
 
 
 bool DFA::has_transition(uint64_t from, char label) const {
-    return edges.count(from) && edges.at(from).count(label);
+    return get_transition(from, label) != dead_state();
 }
 
 
 uint64_t DFA::get_transition(uint64_t from, char label) const {
-    return has_transition(from, label) ? edges.at(from).at(label) : states.size()-1;
+    return from < states.size() ? class_transition(from, byte_class(label)) : dead_state();
 }
 
 }  // namespace dfare::dfa
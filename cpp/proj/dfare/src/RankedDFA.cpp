@@ -3,72 +3,384 @@
  */
 
 #include <algorithm>
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
 #include <iostream>
+#include <random>
 #include <string>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
 
+#include <pur/memory/mapped_file.hpp>
 #include <dfare/dfa/RankedDFA.hpp>
+#include <dfare/exceptions.hpp>
 
 namespace dfare::dfa {
 
+namespace {
+
+/**
+ * Layout of the cache files (native byte order, every section 8-byte aligned):
+ *   header
+ *   alphabet         alphabet_size chars
+ *   byte classes     256 x DFA::class_t
+ *   accepting        states_cnt bytes (0 or 1)
+ *   transitions      states_cnt x classes_cnt uint64
+ *   rank table       (word_length + 1) x states_cnt uint64
+ *   prefix table     word_length x states_cnt x (alphabet_size + 1) uint64
+ */
+struct cache_header {
+    static constexpr char MAGIC[8] = {'D', 'F', 'A', 'R', 'E', 'D', 'F', 'A'};
+    static constexpr uint64_t VERSION = 1;
+
+    char magic[8];
+    uint64_t version;
+    uint64_t content_hash;
+    uint64_t word_length;
+    uint64_t states_cnt;
+    uint64_t built_states_cnt;
+    uint64_t classes_cnt;
+    uint64_t alphabet_size;
+};
+
+struct cache_layout {
+    std::size_t alphabet, byte_classes, accepting, transitions, rank_table, prefix_table, size;
+
+    explicit cache_layout(const cache_header& header) {
+        const auto align = [](std::size_t offset) { return (offset + 7) / 8 * 8; };
+        alphabet = sizeof(cache_header);
+        byte_classes = align(alphabet + header.alphabet_size);
+        accepting = align(byte_classes + 256 * sizeof(DFA::class_t));
+        transitions = align(accepting + header.states_cnt);
+        rank_table = transitions + header.states_cnt * header.classes_cnt * sizeof(uint64_t);
+        prefix_table = rank_table + (header.word_length + 1) * header.states_cnt * sizeof(uint64_t);
+        size = prefix_table
+             + header.word_length * header.states_cnt * (header.alphabet_size + 1) * sizeof(uint64_t);
+    }
+};
+
+}  // namespace
+
 RankedDFA::table_t RankedDFA::build_table(size_t word_length) const {
-    table_t table;
+    const auto states_cnt = dfa.states.size();
+    table_t table((word_length + 1) * states_cnt, 0);
 
-    for (auto& state : dfa.accepting_states) {
-        table[{state, 0}] = 1;
+    for (size_t state = 0; state < states_cnt; ++state) {
+        table[state] = dfa.is_accepting(state);
+    }
+
+    // every layer depends only on the previous one, so its states can be computed in parallel
+    const auto threads_cnt = std::max<std::size_t>(1, std::min<std::size_t>(
+            std::thread::hardware_concurrency(), states_cnt / MIN_STATES_PER_THREAD));
+    const auto chunk = states_cnt / threads_cnt;
+
+    // characters of the same class lead to the same state, so each class is visited once
+    std::vector<uint64_t> class_sizes(dfa.classes_count(), 0);
+    for (auto c : dfa.alphabet.characters()) {
+        ++class_sizes[dfa.byte_class(c)];
+    }
+    std::vector<std::pair<DFA::class_t, uint64_t>> weights;
+    for (size_t cls = 0; cls < class_sizes.size(); ++cls) {
+        if (class_sizes[cls]) {
+            weights.emplace_back(static_cast<DFA::class_t>(cls), class_sizes[cls]);
+        }
     }
 
     for (size_t i = 0; i < word_length; ++i) {
-        for (size_t state = 0; state < dfa.states.size(); ++state) {
-            for (auto& c : dfa.alphabet.characters()) {
-                table[{state, i+1}] += table[{dfa.get_transition(state, c), i}];
+        const auto prev = table.data() + i * states_cnt;
+        const auto next = table.data() + (i + 1) * states_cnt;
+
+        const auto fill = [this, &weights, prev, next](size_t first, size_t last) {
+            for (size_t state = first; state < last; ++state) {
+                for (auto [cls, weight] : weights) {
+                    next[state] += weight * prev[dfa.class_transition(state, cls)];
+                }
             }
+        };
+
+        std::vector<std::thread> workers;
+        for (size_t t = 1; t < threads_cnt; ++t) {
+            workers.emplace_back(fill, t * chunk, t + 1 == threads_cnt ? states_cnt : (t + 1) * chunk);
+        }
+        fill(0, threads_cnt > 1 ? chunk : states_cnt);
+        for (auto& worker : workers) {
+            worker.join();
         }
     }
 
     return table;
 }
 
-std::size_t RankedDFA::rank(const std::string &regex) const {
+RankedDFA::tables_t RankedDFA::build_tables() const {
+    auto owned = std::make_shared<std::pair<table_t, table_t>>();
+    owned->first = build_table(n);
+    owned->second = build_prefix_table(owned->first);
+    return {owned->first.data(), owned->second.data(), owned};
+}
+
+RankedDFA::table_t RankedDFA::build_prefix_table(const table_t& rank_table) const {
+    const auto states_cnt = dfa.states.size();
+    const auto& characters = dfa.alphabet.characters();
+    const auto row_size = characters.size() + 1;
+
+    table_t table(n * states_cnt * row_size, 0);
+
+    for (size_t length = 0; length < n; ++length) {
+        for (size_t state = 0; state < states_cnt; ++state) {
+            auto row = table.data() + (length * states_cnt + state) * row_size;
+            for (size_t j = 0; j < characters.size(); ++j) {
+                auto next = dfa.class_transition(state, dfa.byte_class(characters[j]));
+                row[j + 1] = row[j] + rank_table[length * states_cnt + next];
+            }
+        }
+    }
+
+    return table;
+}
+
+std::size_t RankedDFA::rank(std::string_view word) const {
     std::size_t q = 0;
     std::size_t c = 0;
-    for (size_t i = 0; i < regex.size(); ++i) {
-        for (auto chr = dfa.alphabet.cbegin();
-                  chr < std::find(dfa.alphabet.cbegin(), dfa.alphabet.cend(), regex[i]); ++chr) {
-            c += rank_table[{dfa.get_transition(q, *chr), n - i - 1}];
-        }
-        q = dfa.get_transition(q, regex[i]);
+    // characters past the n-th one have no continuations of the length n, so they don't count
+    for (size_t i = 0; i < std::min(word.size(), n); ++i) {
+        c += prefix_row(q, n - i - 1)[dfa.alphabet.ord(word[i])];
+        q = dfa.get_transition(q, word[i]);
     }
     return c;
 }
 
 std::string RankedDFA::unrank(std::size_t rank) const {
-    std::string regex;
-    int q = 0;
-    int j = 0;
+    std::string word(n, '\0');
+    unrank(rank, word.data());
+    return word;
+}
+
+void RankedDFA::unrank(std::size_t rank, char* word) const {
+    std::size_t q = 0;
+    const auto row_size = dfa.alphabet.characters().size() + 1;
 
     for (std::size_t i = 1; i <= n; ++i) {
+        auto row = prefix_row(q, n - i);
+        // the last character j with row[j] <= rank
+        auto j = static_cast<std::size_t>(std::upper_bound(row, row + row_size, rank) - row) - 1;
+        rank -= row[j];
+
         auto chr = dfa.alphabet.chr(j);
+        word[i - 1] = chr;
+        q = dfa.get_transition(q, chr);
+    }
+}
+
+void RankedDFA::rank_many(const std::string_view* words, std::size_t count, uint64_t* ranks) const {
+    const auto states_cnt = dfa.states.size();
+    const auto row_size = dfa.alphabet.characters().size() + 1;
 
-        auto val = rank_table[{dfa.get_transition(q, chr), n - i}];
-        while (rank >= val) {
-            rank -= val;
-            ++j;
-            chr = dfa.alphabet.chr(j);
-            val = rank_table[{dfa.get_transition(q, chr), n - i}];
+    std::size_t first = 0;
+    for (; first + GROUP_SIZE <= count; first += GROUP_SIZE) {
+        const auto group = words + first;
+        if (!std::all_of(group, group + GROUP_SIZE, [this](auto word) { return word.size() >= n; })) {
+            for (std::size_t lane = 0; lane < GROUP_SIZE; ++lane) {
+                ranks[first + lane] = rank(group[lane]);
+            }
+            continue;
+        }
+
+        std::array<uint64_t, GROUP_SIZE> q {};
+        std::array<uint64_t, GROUP_SIZE> c {};
+        for (std::size_t i = 0; i < n; ++i) {
+            const auto rows = tables.prefix + (n - i - 1) * states_cnt * row_size;
+            for (std::size_t lane = 0; lane < GROUP_SIZE; ++lane) {
+                const auto chr = group[lane][i];
+                c[lane] += rows[q[lane] * row_size + dfa.alphabet.ord(chr)];
+                q[lane] = dfa.class_transition(q[lane], dfa.byte_class(chr));
+            }
+        }
+        std::copy(c.begin(), c.end(), ranks + first);
+    }
+
+    for (; first < count; ++first) {
+        ranks[first] = rank(words[first]);
+    }
+}
+
+std::vector<uint64_t> RankedDFA::rank_many(const std::vector<std::string_view>& words) const {
+    std::vector<uint64_t> ranks(words.size());
+    rank_many(words.data(), words.size(), ranks.data());
+    return ranks;
+}
+
+void RankedDFA::unrank_many(const uint64_t* ranks, std::size_t count, char* words) const {
+    const auto states_cnt = dfa.states.size();
+    const auto row_size = dfa.alphabet.characters().size() + 1;
+
+    for (std::size_t first = 0; first < count; first += GROUP_SIZE) {
+        const auto lanes = std::min(GROUP_SIZE, count - first);
+        std::array<uint64_t, GROUP_SIZE> q {};
+        std::array<uint64_t, GROUP_SIZE> r {};
+        std::copy(ranks + first, ranks + first + lanes, r.begin());
+
+        for (std::size_t i = 0; i < n; ++i) {
+            const auto rows = tables.prefix + (n - i - 1) * states_cnt * row_size;
+            for (std::size_t lane = 0; lane < lanes; ++lane) {
+                const auto row = rows + q[lane] * row_size;
+                // the last character j with row[j] <= rank
+                auto j = static_cast<std::size_t>(std::upper_bound(row, row + row_size, r[lane]) - row) - 1;
+                r[lane] -= row[j];
+
+                const auto chr = dfa.alphabet.chr(j);
+                words[(first + lane) * n + i] = chr;
+                q[lane] = dfa.class_transition(q[lane], dfa.byte_class(chr));
+            }
         }
-        regex += chr;
-        q = dfa.get_transition(q, chr);
-        j = 0;
     }
-    return regex;
+}
+
+std::string RankedDFA::unrank_many(const std::vector<uint64_t>& ranks) const {
+    std::string words(ranks.size() * n, '\0');
+    unrank_many(ranks.data(), ranks.size(), words.data());
+    return words;
 }
 
 size_t RankedDFA::compute_max_rank() const {
-    return rank_table[{0, n}];
+    return count(0, n);
 }
 
-bool RankedDFA::accepts(const std::string &input) const noexcept {
+bool RankedDFA::accepts(std::string_view input) const noexcept {
     return dfa.accepts(input);
 }
 
+uint64_t RankedDFA::content_hash(const std::string& str, std::size_t word_length) noexcept {
+    constexpr uint64_t FNV_OFFSET = 14695981039346656037ull;
+    constexpr uint64_t FNV_PRIME = 1099511628211ull;
+
+    uint64_t hash = FNV_OFFSET;
+    const auto feed = [&hash](const void* data, std::size_t size) {
+        for (std::size_t i = 0; i < size; ++i) {
+            hash = (hash ^ static_cast<const uint8_t*>(data)[i]) * FNV_PRIME;
+        }
+    };
+    const auto length = static_cast<uint64_t>(word_length);
+    feed(str.data(), str.size());
+    feed(&length, sizeof(length));
+    feed(&cache_header::VERSION, sizeof(cache_header::VERSION));
+    return hash;
+}
+
+void RankedDFA::save(const std::string& path, uint64_t hash) const {
+    cache_header header {};
+    std::memcpy(header.magic, cache_header::MAGIC, sizeof(header.magic));
+    header.version = cache_header::VERSION;
+    header.content_hash = hash;
+    header.word_length = n;
+    header.states_cnt = dfa.states.size();
+    header.built_states_cnt = dfa.built_states_count();
+    header.classes_cnt = dfa.classes_count();
+    header.alphabet_size = dfa.alphabet.characters().size();
+    const cache_layout layout {header};
+
+    // written next to the target and renamed, so that readers never see a partial file;
+    // the name is unique, so that concurrent writers of the same cache don't truncate each other's file
+    const auto tmp_path = path + ".tmp." + std::to_string(std::random_device{}())
+            + "." + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+    {
+        std::ofstream file {tmp_path, std::ios::binary | std::ios::trunc};
+        const auto write_at = [&file](std::size_t offset, const void* data, std::size_t size) {
+            while (static_cast<std::size_t>(file.tellp()) < offset) { file.put(0); }
+            file.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+        };
+        write_at(0, &header, sizeof(header));
+        write_at(layout.alphabet, dfa.alphabet.characters().data(), header.alphabet_size);
+        write_at(layout.byte_classes, dfa.m_byte_classes.data(), sizeof(dfa.m_byte_classes));
+        write_at(layout.accepting, dfa.m_accepting.data(), dfa.m_accepting.size());
+        write_at(layout.transitions, dfa.m_transitions.data(), dfa.m_transitions.size() * sizeof(uint64_t));
+        write_at(layout.rank_table, tables.rank, layout.prefix_table - layout.rank_table);
+        write_at(layout.prefix_table, tables.prefix, layout.size - layout.prefix_table);
+        if (!file.flush()) {
+            const auto error = errno;
+            file.close();
+            std::remove(tmp_path.c_str());
+            throw std::system_error(error, std::generic_category(), "RankedDFA: can't write " + tmp_path);
+        }
+    }
+    if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+        const auto error = errno;
+        std::remove(tmp_path.c_str());
+        throw std::system_error(error, std::generic_category(), "RankedDFA: can't replace " + path);
+    }
+}
+
+RankedDFA RankedDFA::load(const std::string& path, uint64_t hash) {
+    auto file = std::make_shared<pur::mapped_file>(path);
+
+    cache_header header {};
+    if (file->size() < sizeof(header)) {
+        throw invalid_dfa_cache(path + " is too short");
+    }
+    std::memcpy(&header, file->data(), sizeof(header));
+    if (std::memcmp(header.magic, cache_header::MAGIC, sizeof(header.magic)) != 0
+        || header.version != cache_header::VERSION) {
+        throw invalid_dfa_cache(path + " has an unknown format");
+    }
+    if (header.content_hash != hash) {
+        throw invalid_dfa_cache(path + " was made for another regexp or word length");
+    }
+    const cache_layout layout {header};
+    if (file->size() != layout.size || header.states_cnt == 0 || header.classes_cnt == 0) {
+        throw invalid_dfa_cache(path + " is corrupted");
+    }
+
+    const auto data = file->data();
+    std::array<DFA::class_t, 256> byte_classes {};
+    std::memcpy(byte_classes.data(), data + layout.byte_classes, sizeof(byte_classes));
+    std::vector<uint64_t> transitions(header.states_cnt * header.classes_cnt);
+    std::memcpy(transitions.data(), data + layout.transitions, transitions.size() * sizeof(uint64_t));
+    // the queries don't check bounds
+    const auto in_range = [](const auto& values, uint64_t bound) {
+        return std::all_of(values.begin(), values.end(), [bound](auto value) { return value < bound; });
+    };
+    if (!in_range(byte_classes, header.classes_cnt) || !in_range(transitions, header.states_cnt)) {
+        throw invalid_dfa_cache(path + " is corrupted");
+    }
+
+    DFA dfa {
+        Alphabet {std::string(reinterpret_cast<const char*>(data + layout.alphabet), header.alphabet_size)},
+        byte_classes,
+        header.classes_cnt,
+        std::move(transitions),
+        std::vector<uint8_t>(data + layout.accepting, data + layout.accepting + header.states_cnt),
+        header.built_states_cnt
+    };
+
+    tables_t tables {
+        reinterpret_cast<const uint64_t*>(data + layout.rank_table),
+        reinterpret_cast<const uint64_t*>(data + layout.prefix_table),
+        std::move(file)
+    };
+    return RankedDFA {std::move(dfa), header.word_length, std::move(tables)};
+}
+
+RankedDFA RankedDFA::from_string_cached(const std::string& str, std::size_t word_length,
+                                        const std::string& cache_path) {
+    const auto hash = content_hash(str, word_length);
+    try {
+        return load(cache_path, hash);
+    } catch (const invalid_dfa_cache&) {
+    } catch (const std::system_error&) {
+    }
+
+    auto ranked = from_string(str, word_length);
+    try {
+        ranked.save(cache_path, hash);
+    } catch (const std::system_error&) {
+        // the cache is only an optimization, the DFA is built anyway
+    }
+    return ranked;
+}
+
 }  // namespace dfare::dfa
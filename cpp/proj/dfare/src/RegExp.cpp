@@ -23,6 +23,10 @@ bool RegExp::operator==(const RegExp &other) const {
     return value == other.value;
 }
 
+int RegExp::compare_to(const RegExp &other) const {
+    return static_cast<unsigned char>(value) - static_cast<unsigned char>(other.value);
+}
+
 bool RegExp::matches_empty() const {
     return false;
 }
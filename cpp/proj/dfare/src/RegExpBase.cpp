@@ -2,14 +2,125 @@
  * author: Adam Budziak
  */
 
+#include <mutex>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include <dfare/regexp/RegExpBase.hpp>
 
 namespace dfare::regexp {
 
+namespace {
+
+struct intern_shard {
+    std::mutex mutex;
+    std::unordered_multimap<std::size_t, const RegExpBase*> nodes;
+};
+
+constexpr std::size_t INTERN_SHARDS = 64;
+
+intern_shard& shard_of(std::size_t hash) {
+    // never destroyed, since nodes held in static variables may outlive it otherwise
+    static auto* shards = new intern_shard[INTERN_SHARDS];
+    return shards[hash % INTERN_SHARDS];
+}
+
+void unregister(const RegExpBase* node) {
+    auto& shard = shard_of(node->hash());
+    std::lock_guard<std::mutex> lock {shard.mutex};
+    auto [first, last] = shard.nodes.equal_range(node->hash());
+    for (auto it = first; it != last; ++it) {
+        if (it->second == node) {
+            shard.nodes.erase(it);
+            break;
+        }
+    }
+}
+
+// destroying the nodes releases their children, which lock their shards,
+// so the nodes are unregistered first
+
+void release(const RegExpBase* node) {
+    unregister(node);
+    delete node;
+}
+
+void release_in_arena(const RegExpBase* node) {
+    unregister(node);
+    node->~RegExpBase();
+}
+
+bool allocated_in_arena(const std::shared_ptr<const RegExpBase>& node) {
+    auto deleter = std::get_deleter<void (*)(const RegExpBase*)>(node);
+    return deleter != nullptr && *deleter == release_in_arena;
+}
+
+}  // namespace
+
+
+regexp_ptr detail::intern(const RegExpBase* node, std::shared_ptr<pur::arena> arena) {
+    std::shared_ptr<const RegExpBase> candidate = arena
+            ? std::shared_ptr<const RegExpBase>{node, release_in_arena, pur::arena_allocator<char>{std::move(arena)}}
+            : std::shared_ptr<const RegExpBase>{node, release};
+
+    auto& shard = shard_of(node->hash());
+    std::lock_guard<std::mutex> lock {shard.mutex};
+    auto [first, last] = shard.nodes.equal_range(node->hash());
+    for (auto it = first; it != last; ++it) {
+        if (*it->second == *node) {
+            // the node may be dying already, then it is about to be released
+            if (auto alive = it->second->weak_from_this().lock()) {
+                return regexp_ptr{std::move(alive)};
+            }
+        }
+    }
+    shard.nodes.emplace(node->hash(), node);
+    return regexp_ptr{std::move(candidate)};
+}
+
+
+regexp_ptr detail::intern_on_heap(const RegExpBase* node) {
+    std::shared_ptr<const RegExpBase> candidate {node, release};
+    // released only after the shard is unlocked, since releasing a node locks its shard
+    std::vector<std::shared_ptr<const RegExpBase>> replaced;
+
+    auto& shard = shard_of(node->hash());
+    std::lock_guard<std::mutex> lock {shard.mutex};
+    auto [first, last] = shard.nodes.equal_range(node->hash());
+    for (auto it = first; it != last;) {
+        if (*it->second == *node) {
+            if (auto alive = it->second->weak_from_this().lock()) {
+                if (!allocated_in_arena(alive)) {
+                    return regexp_ptr{std::move(alive)};
+                }
+                // it isn't found again, the copy is; unregistering it once it dies is a no-op
+                replaced.push_back(std::move(alive));
+                it = shard.nodes.erase(it);
+                continue;
+            }
+        }
+        ++it;
+    }
+    shard.nodes.emplace(node->hash(), node);
+    return regexp_ptr{std::move(candidate)};
+}
+
+
+bool detail::in_arena(const regexp_ptr& regex) {
+    return allocated_in_arena(regex->weak_from_this().lock());
+}
+
+
+int RegExpBase::compare(const RegExpBase &other) const {
+    if (this == &other) { return 0; }
+    if (kind() != other.kind()) { return kind() < other.kind() ? -1 : 1; }
+    return compare_same_kind(other);
+}
+
+
 bool regexp_ptr::operator==(const regexp_ptr &other) const {
-    return *ptr == *(other.ptr);
+    return ptr == other.ptr || *ptr == *(other.ptr);
 }
 
 bool regexp_ptr::operator==(const RegExpBase& other) const {
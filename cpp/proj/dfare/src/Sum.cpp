@@ -4,6 +4,8 @@
 
 #include <string>
 #include <algorithm>
+#include <functional>
+#include <vector>
 #include <utility>
 
 #include <dfare/regexp/Sum.hpp>
@@ -28,24 +30,38 @@ bool Sum::matches_empty() const {
     return left.matches_empty() || right.matches_empty();
 }
 
+int Sum::compare_to(const Sum &other) const {
+    auto result = left->compare(*other.left);
+    return result != 0 ? result : right->compare(*other.right);
+}
+
 regexp_ptr Sum::create(regexp_ptr left, regexp_ptr right) {
-    static const auto cast = [](const RegExpBase* ptr) { return dynamic_cast<const Sum*>(ptr); };
     if (left == right) return left;
     if (left == Empty::create()) return right;
     if (right == Empty::create()) return left;
 
-    if (auto left_sum = cast(left.get()); left_sum) {
-        if (left_sum->left == right || left_sum->right == right) {
-            return left;
-        }
-    }
-    if (auto right_sum = cast(right.get()); right_sum) {
-        if (right_sum->left == left || right_sum->right == left) {
-            return right;
+    std::vector<regexp_ptr> operands;
+    const std::function<void(const regexp_ptr&)> flatten = [&operands, &flatten](const regexp_ptr& regex) {
+        if (auto sum = dynamic_cast<const Sum*>(regex.get()); sum) {
+            flatten(sum->left);
+            flatten(sum->right);
+        } else if (!(regex == Empty::create())) {
+            operands.push_back(regex);
         }
-    }
+    };
+    flatten(left);
+    flatten(right);
 
-    return RegExpBase_<Sum>::create(std::move(left), std::move(right));
+    std::sort(operands.begin(), operands.end(),
+              [](const regexp_ptr& a, const regexp_ptr& b) { return a->compare(*b) < 0; });
+    operands.erase(std::unique(operands.begin(), operands.end()), operands.end());
+    if (operands.empty()) return Empty::create();
+
+    auto result = operands.back();
+    for (auto it = std::next(operands.rbegin()); it != operands.rend(); ++it) {
+        result = RegExpBase_<Sum>::create(*it, result);
+    }
+    return result;
 }
 
 bool Sum::equivalent(const Sum &other) const {
@@ -0,0 +1,72 @@
+/*
+ * author: Adam Budziak
+ */
+
+#include <unordered_map>
+
+#include <dfare/regexp/arena_scope.hpp>
+#include <dfare/regexp/Closure.hpp>
+#include <dfare/regexp/Concat.hpp>
+#include <dfare/regexp/Empty.hpp>
+#include <dfare/regexp/Eps.hpp>
+#include <dfare/regexp/RegExp.hpp>
+#include <dfare/regexp/Sum.hpp>
+
+namespace dfare::regexp {
+
+namespace {
+
+thread_local std::shared_ptr<pur::arena> arena_of_thread;
+
+using copies_t = std::unordered_map<const RegExpBase*, regexp_ptr>;
+
+// the nodes are already in their canonical forms, so they are rebuilt with the plain constructors
+regexp_ptr copy_to_heap(const regexp_ptr& regex, copies_t& copies) {
+    if (!detail::in_arena(regex)) {
+        return regex;
+    }
+    if (auto copy = copies.find(regex.get()); copy != copies.end()) {
+        return copy->second;
+    }
+
+    const RegExpBase* node = nullptr;
+    if (auto concat = dynamic_cast<const Concat*>(regex.get())) {
+        node = new Concat(copy_to_heap(concat->left, copies), copy_to_heap(concat->right, copies));
+    } else if (auto sum = dynamic_cast<const Sum*>(regex.get())) {
+        node = new Sum(copy_to_heap(sum->left, copies), copy_to_heap(sum->right, copies));
+    } else if (auto closure = dynamic_cast<const Closure*>(regex.get())) {
+        node = new Closure(copy_to_heap(closure->value, copies));
+    } else {
+        // Empty and Eps never live in the arenas, so only letters are left
+        node = new RegExp(dynamic_cast<const RegExp&>(*regex));
+    }
+    return copies[regex.get()] = detail::intern_on_heap(node);
+}
+
+}  // namespace
+
+arena_scope::arena_scope() : arena_scope {std::make_shared<pur::arena>()} {  }
+
+arena_scope::arena_scope(std::shared_ptr<pur::arena> arena) : m_arena {std::move(arena)}, m_previous {arena_of_thread} {
+    // the singletons live forever, they mustn't pin the arena
+    Empty::create();
+    Eps::create();
+    arena_of_thread = m_arena;
+}
+
+arena_scope::~arena_scope() {
+    arena_of_thread = std::move(m_previous);
+}
+
+void detach_from_arenas(std::vector<regexp_ptr>& regexps) {
+    copies_t copies;
+    for (auto& regex : regexps) {
+        regex = copy_to_heap(regex, copies);
+    }
+}
+
+const std::shared_ptr<pur::arena>& detail::current_arena() noexcept {
+    return arena_of_thread;
+}
+
+}  // namespace dfare::regexp
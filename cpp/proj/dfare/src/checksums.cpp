@@ -0,0 +1,60 @@
+/*
+ * author: Adam Budziak
+ */
+
+#include <stdexcept>
+
+#include <dfare/dfa/checksums.hpp>
+#include <dfare/regexp/Empty.hpp>
+
+namespace dfare::dfa::checksums {
+
+namespace {
+
+const std::string DIGITS = "0123456789";
+
+/**
+ * Minimal DFA over the digits with the states 0, ..., states_cnt - 1 (0 is the start),
+ * and the transitions given by the function.
+ */
+template <typename Next_F, typename Accept_F>
+DFA digits_automaton(uint64_t states_cnt, Next_F next, Accept_F accept) {
+    DFA::edges_t edges;
+    DFA::accept_states_t accepting;
+    for (uint64_t state = 0; state < states_cnt; ++state) {
+        if (accept(state)) { accepting.push_back(state); }
+        for (char c : DIGITS) {
+            edges[state][c] = next(state, static_cast<uint64_t>(c - '0'));
+        }
+    }
+    DFA::states_t states(states_cnt + 1, regexp::Empty::create());
+    return DFA{std::move(states), std::move(edges), std::move(accepting), Alphabet{DIGITS}}.minimized();
+}
+
+}  // namespace
+
+
+DFA luhn() {
+    // the state is a pair of sums mod 10: with the last digit read so far kept as is,
+    // and with it doubled; the next digit swaps the roles of the two
+    const auto doubled = [](uint64_t digit) { return digit < 5 ? 2 * digit : 2 * digit - 9; };
+    return digits_automaton(100,
+        [&doubled](uint64_t state, uint64_t digit) {
+            auto as_is = state / 10;
+            auto as_doubled = state % 10;
+            return ((as_doubled + digit) % 10) * 10 + (as_is + doubled(digit)) % 10;
+        },
+        [](uint64_t state) { return state / 10 == 0; });
+}
+
+
+DFA mod(uint64_t modulus, uint64_t residue) {
+    if (modulus == 0 || residue >= modulus) {
+        throw std::invalid_argument("checksums::mod: the residue has to be less than the modulus");
+    }
+    return digits_automaton(modulus,
+        [modulus](uint64_t state, uint64_t digit) { return (state * 10 + digit) % modulus; },
+        [residue](uint64_t state) { return state == residue; });
+}
+
+}  // namespace dfare::dfa::checksums
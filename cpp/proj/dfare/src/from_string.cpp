@@ -151,11 +151,8 @@ std::string preprocess(const std::string& str_) {
 
 regexp_ptr from_string_(const std::string& str_) {
     std::stack<regexp_ptr> stack;
-    std::cout << preprocess(str_) << '\n';
     auto str = insert_operators(preprocess(str_));
-    std::cout << str_ << '\n';
     auto postfix = infix_to_postfix(str);
-    std::cout << postfix << '\n';
 
     for (std::size_t i = 0; i < postfix.size(); ++i) {
         if (!is_operator(postfix[i])) {
@@ -3,10 +3,17 @@
  */
 
 #include <chrono>
+#include <string>
+#include <vector>
+
+#include <dfare/dfa/RankedDFA.hpp>
+#include <dfare/dfa/checksums.hpp>
+#include <grafpe/rte/DFA.hpp>
 
 #include <grafpe/aes/openssl/AesCtr128PRNG.hpp>
 #include <grafpe/crypt/Cast.hpp>
 #include <grafpe/crypt/Grafpe.hpp>
+#include <grafpe/crypt/RadixGrafpe.hpp>
 #include <grafpe/prng/utils.hpp>
 #include <grafpe/prng/DummyPRNG.hpp>
 #include <grafpe/crypt/Targeted.hpp>
@@ -19,7 +26,7 @@ using namespace grafpe;
 static constexpr uint64_t BASE = 10000;
 
 bool luhn_checksum(uint64_t number) {
-    static const auto NUM_SIZE = static_cast<uint64_t>(pow(10, 15));
+    static constexpr uint64_t NUM_SIZE = 1'000'000'000'000'000;
 
     if (number < NUM_SIZE || number >= NUM_SIZE * 10) {
         return false;
@@ -85,7 +92,9 @@ int main() {
 
     auto ccn_crypter = crypter::Targeted {
         domain::targeting::CycleWalker<decltype(dgt16_crypter)>{&luhn_checksum},
-//        domain::targeting::CycleSlicer<decltype(dgt16_crypter)>{{key, iv}, [](auto& a, auto& b) { return luhn_checksum(a) && luhn_checksum(b);}, 100},
+//        domain::targeting::CycleSlicer<decltype(dgt16_crypter)>::from_tv_threshold(
+//                {key, iv}, [](auto& a, auto& b) { return luhn_checksum(a) && luhn_checksum(b);},
+//                BASE * BASE * BASE * BASE, BASE * BASE * BASE * BASE / 10, 1e-6),
         dgt16_crypter
     };
 
@@ -107,7 +116,51 @@ int main() {
 
     std::cout << "CCN benchmark: " << benchmark  << '\n';
 
+    // the same numbers encrypted as one batch, the cycle walker keeps refilling its lanes
+    std::vector<uint64_t> numbers;
+    for (uint64_t i = start; i < start + total; ++i) {
+        if (luhn_checksum(i)) { numbers.push_back(i); }
+    }
+    auto batch_start = high_resolution_clock::now();
+    auto encrypted = ccn_crypter.encrypt_batch(numbers);
+    auto batch_end = high_resolution_clock::now();
+    assert(ccn_crypter.decrypt_batch(encrypted) == numbers);
+
+    std::cout << "CCN batch benchmark: "
+              << duration_cast<microseconds>(batch_end - batch_start).count() / double(total) << '\n';
+
     std::cout << luhn_checksum(1234123412341238) << std::endl;
 
     std::cout << ccn_crypter.encrypt(1234123412341238) << std::endl;
+
+    // Step 2: compile the Luhn check into the automaton of the format instead,
+    //  its words are ranked exactly, so only the ranks have to be encrypted.
+    //  RadixGrafpe splits them into 4 digits in the smallest base covering all of them,
+    //  which leaves almost nothing to cycle-walk over.
+    std::string format = "(1+2+3+4+5+6+7+8+9)";
+    for (int i = 1; i < 16; ++i) {
+        format += "(0+1+2+3+4+5+6+7+8+9)";
+    }
+    auto ccn_dfa = dfare::dfa::RankedDFA {
+        dfare::dfa::DFA::from_regex(dfare::regexp::from_string(format), true)
+            .intersected(dfare::dfa::checksums::luhn()),
+        16
+    };
+    auto dfa_crypter = rte::DFA {
+        ccn_dfa,
+        crypter::RadixGrafpe<> {key, iv, ccn_dfa.max_rank, 4, 432, static_cast<point_t>(BASE)}
+    };
+
+    benchmark = 0;
+    for (auto number : numbers) {
+        auto str = std::to_string(number);
+        auto start = high_resolution_clock::now();
+        auto encrypted = dfa_crypter.encrypt(str);
+        auto end = high_resolution_clock::now();
+        assert(luhn_checksum(std::stoull(encrypted)) && dfa_crypter.decrypt(encrypted) == str);
+        benchmark += duration_cast<microseconds>(end - start).count() / double(total);
+    }
+
+    std::cout << "CCN DFA benchmark: " << benchmark << '\n';
+    std::cout << dfa_crypter.encrypt("1234123412341238") << std::endl;
 }
@@ -2,44 +2,97 @@
  * author: Adam Budziak
  */
 
-#include <iostream>
+#include <algorithm>
 #include <cassert>
+#include <iostream>
+#include <stdexcept>
+#include <string_view>
 #include <grafpe/crypt/ScalarGrafpe.hpp>
 #include <grafpe/crypt/Grafpe.hpp>
 #include <grafpe/prng/DummyPRNG.hpp>
 #include <grafpe/prng/utils.hpp>
 #include <grafpe/aes/openssl/AesCtr128PRNG.hpp>
 #include <grafpe/common/print_utils.hpp>
-#include <dfare/dfa/RankedDFA.hpp>
-#include <grafpe/rte/DFA.hpp>
-#include <grafpe/rte/Container.hpp>
-#include <grafpe/crypt/Tuple.hpp>
+#include <dfare/common/Alphabet.hpp>
+#include <grafpe/rte/Characters.hpp>
+#include <grafpe/crypt/Cast.hpp>
+#include <grafpe/crypt/Codebook.hpp>
 
 using namespace grafpe;
 using namespace std::string_literals;
 using grafpe::aes::openssl::AesCtr128PRNG;
 
+/*
+ * A short list of words encrypted by their positions in the list.
+ */
 template <typename Crypter_T>
-class NameCrypter: public crypter::CastCrypter<Crypter_T, std::string> {
-    dfare::dfa::RankedDFA m_dfa;
+class WordCrypter: public crypter::StringCastCrypter<Crypter_T> {
+    std::vector<std::string> m_words;
 public:
-    explicit NameCrypter(dfare::dfa::RankedDFA dfa, Crypter_T crypter):
-        crypter::CastCrypter<Crypter_T, std::string>(std::move(crypter)),
-        m_dfa {std::move(dfa)} {}
+    WordCrypter(std::vector<std::string> words, Crypter_T crypter):
+        crypter::StringCastCrypter<Crypter_T>(std::move(crypter)),
+        m_words {std::move(words)} {}
 
 protected:
-    perm_t cast_impl(const std::string &value) const override {
-        perm_t casted(value.size());
-        std::transform(value.begin(), value.end(), casted.begin(),
-                [this](char c){ return m_dfa.rank(std::string{c});});
-        return casted;
+    point_t cast_impl(std::string_view value) const override {
+        auto it = std::find(m_words.begin(), m_words.end(), value);
+        if (it == m_words.end()) {
+            throw std::out_of_range("WordCrypter: unknown word");
+        }
+        return static_cast<point_t>(std::distance(m_words.begin(), it));
     }
 
-    std::string uncast_impl(const perm_t &value) const override {
-        std::string uncasted(value.size(), '\0');
-        std::transform(value.begin(), value.end(), uncasted.begin(),
-                [this](point_t p){ return m_dfa.unrank(p)[0];});
-        return uncasted;
+    void uncast_impl(const point_t &value, std::string& out) const override {
+        out += m_words.at(value);
+    }
+};
+
+template <typename Name_T, typename Domain_T, typename Extension_T>
+class EmailCrypter: public crypter::Base<std::string> {
+    Name_T m_name;
+    Domain_T m_domain;
+    Extension_T m_extension;
+
+public:
+    EmailCrypter(Name_T name, Domain_T domain, Extension_T extension):
+        m_name {std::move(name)}, m_domain {std::move(domain)}, m_extension {std::move(extension)} {  }
+
+    // the fields are views of the address and are appended to `out` one by one, nothing is copied
+    void encrypt_into(std::string_view value, std::string& out, const tweak_t& tweak = {}) const {
+        for_each_field(value, out, [&tweak](const auto& crypter, std::string_view field, std::string& result) {
+            crypter.encrypt_into(field, result, tweak);
+        });
+    }
+
+    void decrypt_into(std::string_view value, std::string& out, const tweak_t& tweak = {}) const {
+        for_each_field(value, out, [&tweak](const auto& crypter, std::string_view field, std::string& result) {
+            crypter.decrypt_into(field, result, tweak);
+        });
+    }
+
+protected:
+    std::string encrypt_impl(const std::string& value, const tweak_t& tweak) const override {
+        std::string result;
+        encrypt_into(value, result, tweak);
+        return result;
+    }
+
+    std::string decrypt_impl(const std::string& value, const tweak_t& tweak) const override {
+        std::string result;
+        decrypt_into(value, result, tweak);
+        return result;
+    }
+
+private:
+    template <typename Field_F>
+    void for_each_field(std::string_view value, std::string& out, Field_F field) const {
+        std::size_t at_pos { value.find('@') };
+        std::size_t dot_pos { value.find('.', at_pos)};
+        field(m_name, value.substr(0, at_pos), out);
+        out += '@';
+        field(m_domain, value.substr(at_pos + 1, dot_pos - at_pos - 1), out);
+        out += '.';
+        field(m_extension, value.substr(dot_pos + 1), out);
     }
 };
 
@@ -56,55 +109,27 @@ auto _prepare_crypter(const key_type& key, const iv_type& iv) {
         "pl", "edu", "com", "net", "eu", "en"
     };
 
-    auto domains_crypter = rte::Container{
+    // the domains are tiny, so the whole permutations can be precomputed
+    auto domains_crypter = WordCrypter{
         domains,
-        ScalarGrafpe{key, iv, domains.size(), 2, 100}
+        crypter::Codebook{ScalarGrafpe{key, iv, domains.size(), 2, 100}, domains.size()}
     };
 
-    auto extensions_crypter = rte::Container{
+    auto extensions_crypter = WordCrypter{
         extensions,
-        ScalarGrafpe{key, iv, extensions.size(), 2, 100}
+        crypter::Codebook{ScalarGrafpe{key, iv, extensions.size(), 2, 100}, extensions.size()}
     };
 
-    const std::string name_regex = "[a-z]";
-
-    auto ranked_dfa = dfare::dfa::RankedDFA::from_string(name_regex, 1);
+    const auto name_alphabet = dfare::Alphabet{"abcdefghijklmnopqrstuvwxyz"};
 
-    auto name_crypter = NameCrypter{
-        ranked_dfa,
-        crypter::Grafpe<>{key, iv, ranked_dfa.max_rank, 4u, 100u}
+    auto name_crypter = rte::Characters{
+        name_alphabet,
+        crypter::Grafpe<>{key, iv, name_alphabet.characters().size(), 4u, 100u}
     };
 
-    return crypter::Tuple{name_crypter, domains_crypter, extensions_crypter};
+    return EmailCrypter{name_crypter, domains_crypter, extensions_crypter};
 }
 
-template <typename Crypter_T>
-class EmailCrypter: public crypter::CastCrypter<Crypter_T, std::string> {
- public:
-    using value_type = std::string;
-
-    explicit EmailCrypter(Crypter_T crypter):
-        crypter::CastCrypter<Crypter_T, std::string>{std::move(crypter)} {  }
-
- private:
-    using tuple_t = typename Crypter_T::value_type;
-
-protected:
-    tuple_t cast_impl(const value_type& value) const override {
-        std::size_t at_pos { value.find('@') };
-        std::size_t dot_pos { value.find('.', at_pos)};
-        return std::tuple {
-                value.substr(0, at_pos),
-                value.substr(at_pos + 1, dot_pos - at_pos - 1),
-                value.substr(dot_pos + 1)
-        };
-    }
-
-    std::string uncast_impl(const tuple_t& tuple) const override {
-        return std::get<0>(tuple) + '@' + std::get<1>(tuple) + '.' + std::get<2>(tuple);
-    }
-};
-
 int main() {
     auto key = random_array<AesCtr128PRNG::key_type>(DummyPRNG{});
     auto  iv = random_array<AesCtr128PRNG::iv_type>(DummyPRNG{});
@@ -112,10 +137,21 @@ int main() {
     std::cout << "Key = " << bytes_to_hex(key) << '\n'
               << " IV = " << bytes_to_hex(iv) << '\n';
 
-    EmailCrypter crypter{_prepare_crypter(key, iv)};
+    auto crypter = _prepare_crypter(key, iv);
 
     auto plaintext = "helloworld@gmail.com"s;
     std::cout << plaintext << '\n'
               << crypter.encrypt(plaintext) << '\n'
               << crypter.decrypt(crypter.encrypt(plaintext)) << '\n';
+
+    // a single buffer reused for all the addresses
+    std::string encrypted, decrypted;
+    for (const auto address : {"alice@wp.pl", "bob@protonmail.com", "carol@yahoo.eu"}) {
+        encrypted.clear();
+        decrypted.clear();
+        crypter.encrypt_into(address, encrypted);
+        crypter.decrypt_into(encrypted, decrypted);
+        assert(decrypted == address);
+        std::cout << address << " -> " << encrypted << '\n';
+    }
 }
@@ -6,7 +6,10 @@
 
 #include <vector>
 #include <memory>
+#include <string>
+#include <string_view>
 #include "Crypter.hpp"
+#include "batch.hpp"
 
 namespace grafpe::crypter {
 
@@ -29,6 +32,39 @@ class CastCrypter: public Base<Value_T> {
         return uncast_impl(value);
     }
 
+    /**
+     * Encrypts `count` values under the same tweak: they are cast in chunks
+     * and every chunk goes through the batch API of the wrapped crypter (if it has one).
+     * `in` and `out` may be the same buffer.
+     */
+    void encrypt_batch(const value_type* in, value_type* out, std::size_t count, const tweak_t& tweak = {}) const {
+        cast_batch(in, out, count, [this, &tweak](const crypter_value_t* values, crypter_value_t* result, std::size_t n) {
+            crypter::encrypt_batch(m_crypter, values, result, n, tweak);
+        });
+    }
+
+    /**
+     * Decrypts `count` values under the same tweak.
+     * @see encrypt_batch
+     */
+    void decrypt_batch(const value_type* in, value_type* out, std::size_t count, const tweak_t& tweak = {}) const {
+        cast_batch(in, out, count, [this, &tweak](const crypter_value_t* values, crypter_value_t* result, std::size_t n) {
+            crypter::decrypt_batch(m_crypter, values, result, n, tweak);
+        });
+    }
+
+    std::vector<value_type> encrypt_batch(const std::vector<value_type>& values, const tweak_t& tweak = {}) const {
+        std::vector<value_type> result(values.size());
+        encrypt_batch(values.data(), result.data(), values.size(), tweak);
+        return result;
+    }
+
+    std::vector<value_type> decrypt_batch(const std::vector<value_type>& values, const tweak_t& tweak = {}) const {
+        std::vector<value_type> result(values.size());
+        decrypt_batch(values.data(), result.data(), values.size(), tweak);
+        return result;
+    }
+
  protected:
     value_type encrypt_impl(const value_type &value, const tweak_t &tweak) const final {
         return uncast_impl(m_crypter.encrypt(cast_impl(value), tweak));
@@ -40,7 +76,122 @@ class CastCrypter: public Base<Value_T> {
 
     virtual crypter_value_t cast_impl(const value_type &value) const = 0;
     virtual value_type uncast_impl(const crypter_value_t &value) const = 0;
+
+ private:
+    template <typename Batch_F>
+    void cast_batch(const value_type* in, value_type* out, std::size_t count, Batch_F batch) const {
+        crypter::cast_batch<crypter_value_t>(in, out, count,
+                [this](const auto& value) { return cast_impl(value); },
+                batch,
+                [this](const crypter_value_t& value, value_type& result) { result = uncast_impl(value); });
+    }
 };
 
-}
 
+/**
+ * CastCrypter of strings working without intermediate copies.
+ *
+ * The cast side reads a std::string_view and the uncast side appends to
+ * a caller-provided buffer, so encrypt_into/decrypt_into don't allocate
+ * (apart from growing the buffer and whatever the wrapped crypter allocates).
+ * Reusing one buffer, or appending the fields of a record one after another,
+ * makes string-format encryption allocation-free for integral crypters.
+ */
+template<typename Crypter_T>
+class StringCastCrypter: public Base<std::string> {
+    using crypter_value_t = typename Crypter_T::value_type;
+    Crypter_T m_crypter;
+
+ public:
+    using value_type = std::string;
+
+    explicit StringCastCrypter(Crypter_T crypter): m_crypter { std::move(crypter) } { }
+    ~StringCastCrypter() = default;
+
+    crypter_value_t cast(std::string_view value) const {
+        return cast_impl(value);
+    }
+
+    /**
+     * Appends the string of the value to `out`.
+     */
+    void uncast(const crypter_value_t& value, std::string& out) const {
+        uncast_impl(value, out);
+    }
+
+    /**
+     * Encrypts the value and appends the result to `out`.
+     */
+    void encrypt_into(std::string_view value, std::string& out, const tweak_t& tweak = {}) const {
+        uncast_impl(m_crypter.encrypt(cast_impl(value), tweak), out);
+    }
+
+    /**
+     * Decrypts the value and appends the result to `out`.
+     */
+    void decrypt_into(std::string_view value, std::string& out, const tweak_t& tweak = {}) const {
+        uncast_impl(m_crypter.decrypt(cast_impl(value), tweak), out);
+    }
+
+    /**
+     * Encrypts `count` values under the same tweak, see CastCrypter::encrypt_batch.
+     * The strings in `out` are overwritten in place, so their buffers are reused.
+     */
+    void encrypt_batch(const value_type* in, value_type* out, std::size_t count, const tweak_t& tweak = {}) const {
+        cast_batch(in, out, count, [this, &tweak](const crypter_value_t* values, crypter_value_t* result, std::size_t n) {
+            crypter::encrypt_batch(m_crypter, values, result, n, tweak);
+        });
+    }
+
+    /**
+     * Decrypts `count` values under the same tweak.
+     * @see encrypt_batch
+     */
+    void decrypt_batch(const value_type* in, value_type* out, std::size_t count, const tweak_t& tweak = {}) const {
+        cast_batch(in, out, count, [this, &tweak](const crypter_value_t* values, crypter_value_t* result, std::size_t n) {
+            crypter::decrypt_batch(m_crypter, values, result, n, tweak);
+        });
+    }
+
+    std::vector<value_type> encrypt_batch(const std::vector<value_type>& values, const tweak_t& tweak = {}) const {
+        std::vector<value_type> result(values.size());
+        encrypt_batch(values.data(), result.data(), values.size(), tweak);
+        return result;
+    }
+
+    std::vector<value_type> decrypt_batch(const std::vector<value_type>& values, const tweak_t& tweak = {}) const {
+        std::vector<value_type> result(values.size());
+        decrypt_batch(values.data(), result.data(), values.size(), tweak);
+        return result;
+    }
+
+ protected:
+    value_type encrypt_impl(const value_type &value, const tweak_t &tweak) const final {
+        std::string result;
+        encrypt_into(value, result, tweak);
+        return result;
+    }
+
+    value_type decrypt_impl(const value_type &value, const tweak_t &tweak) const final {
+        std::string result;
+        decrypt_into(value, result, tweak);
+        return result;
+    }
+
+    virtual crypter_value_t cast_impl(std::string_view value) const = 0;
+    virtual void uncast_impl(const crypter_value_t &value, std::string& out) const = 0;
+
+ private:
+    template <typename Batch_F>
+    void cast_batch(const value_type* in, value_type* out, std::size_t count, Batch_F batch) const {
+        crypter::cast_batch<crypter_value_t>(in, out, count,
+                [this](const auto& value) { return cast_impl(value); },
+                batch,
+                [this](const crypter_value_t& value, value_type& result) {
+                    result.clear();
+                    uncast_impl(value, result);
+                });
+    }
+};
+
+}
@@ -0,0 +1,171 @@
+/*
+ * author: Adam Budziak
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <pur/containers/lru_cache.hpp>
+#include <grafpe/crypt/Crypter.hpp>
+#include <grafpe/common/type_utils.hpp>
+
+namespace grafpe::crypter {
+
+/**
+ * Crypter wrapper precomputing the whole permutation of a small integer domain.
+ *
+ * For every tweak the forward and inverse tables of the wrapped crypter
+ * are computed (in parallel) on the first use and cached, so that later
+ * calls cost a single array lookup. The tables are kept in an LRU cache
+ * bounded by the memory budget given in bytes.
+ *
+ * The domain is {0, ..., N - 1}. If the wrapped crypter permutes only a subset
+ * of it (e.g. it is a Targeted crypter), the subset has to be described
+ * by the domain function. Values outside of the domain are rejected with std::out_of_range.
+ *
+ * If the wrapped crypter has size(), it has to be N. A crypter mapping a value
+ * of the domain outside of {0, ..., N - 1} is reported with std::logic_error.
+ *
+ * The wrapped crypter is called concurrently, so it has to be thread-safe.
+ *
+ * @tparam Crypter_T - crypter with integral value_type
+ */
+template <typename Crypter_T>
+class Codebook: public Base<typename Crypter_T::value_type> {
+ public:
+    using value_type = typename Crypter_T::value_type;
+    using domain_fn_type = std::function<bool(const value_type&)>;
+
+    static constexpr std::size_t DEFAULT_MEMORY_BUDGET = 64u << 20u;
+
+ private:
+    struct tables_t {
+        std::vector<value_type> forward;
+        std::vector<value_type> backward;
+    };
+
+    using cache_t = pur::lru_cache<uint64_t, tables_t>;
+
+    template <typename T, typename = void>
+    struct has_size : std::false_type {};
+
+    template <typename T>
+    struct has_size<T, std::void_t<decltype(std::declval<const T&>().size())>> : std::true_type {};
+
+    static constexpr value_type NOT_IN_DOMAIN = std::numeric_limits<value_type>::max();
+    static constexpr value_type MIN_VALUES_PER_THREAD = 1024;
+
+    Crypter_T m_crypter;
+    value_type m_size;
+    domain_fn_type m_in_domain;
+    std::shared_ptr<cache_t> m_cache;
+
+ public:
+    Codebook(Crypter_T crypter, value_type size, std::size_t memory_budget = DEFAULT_MEMORY_BUDGET)
+      : Codebook(std::move(crypter), size, nullptr, memory_budget) {  }
+
+    Codebook(Crypter_T crypter, value_type size, domain_fn_type in_domain,
+             std::size_t memory_budget = DEFAULT_MEMORY_BUDGET)
+      : m_crypter {std::move(crypter)}, m_size {size}, m_in_domain {std::move(in_domain)},
+        m_cache {std::make_shared<cache_t>(memory_budget)} {
+        static_assert(std::is_integral_v<value_type>);
+        if constexpr (has_size<Crypter_T>::value) {
+            if (m_crypter.size() != m_size) {
+                throw std::invalid_argument("Codebook: size differs from the domain of the crypter");
+            }
+        }
+        if (tables_cost() > memory_budget) {
+            throw std::invalid_argument("Codebook: memory budget too small for a single codebook");
+        }
+    }
+
+    [[nodiscard]] value_type size() const noexcept { return m_size; }
+
+    [[nodiscard]] const Crypter_T& crypter() const noexcept { return m_crypter; }
+
+    [[nodiscard]] pur::cache_statistics cache_stats() const { return m_cache->stats(); }
+
+ private:
+    value_type encrypt_impl(const value_type& value, const tweak_t& tweak) const override {
+        return lookup(get_tables(tweak)->forward, value);
+    }
+
+    value_type decrypt_impl(const value_type& value, const tweak_t& tweak) const override {
+        return lookup(get_tables(tweak)->backward, value);
+    }
+
+    std::size_t tables_cost() const noexcept {
+        return 2 * static_cast<std::size_t>(m_size) * sizeof(value_type);
+    }
+
+    value_type lookup(const std::vector<value_type>& table, const value_type& value) const {
+        if (value >= m_size || table[value] == NOT_IN_DOMAIN) {
+            throw std::out_of_range("Codebook: value outside of the domain");
+        }
+        return table[value];
+    }
+
+    typename cache_t::value_ptr get_tables(const tweak_t& tweak) const {
+        if (auto tables = m_cache->find(*tweak.data())) {
+            return tables;
+        }
+        return m_cache->insert(*tweak.data(), build_tables(tweak), tables_cost());
+    }
+
+    tables_t build_tables(const tweak_t& tweak) const;
+};
+
+
+template<typename Crypter_T>
+auto Codebook<Crypter_T>::build_tables(const tweak_t& tweak) const -> tables_t {
+    tables_t tables {
+        std::vector<value_type>(m_size, NOT_IN_DOMAIN),
+        std::vector<value_type>(m_size, NOT_IN_DOMAIN)
+    };
+
+    // set by the threads instead of throwing, which would terminate them
+    std::atomic<bool> out_of_table {false};
+
+    // every thread writes distinct cells of both tables, since the crypter is a permutation
+    const auto fill = [this, &tables, &tweak, &out_of_table](value_type first, value_type last) {
+        for (value_type x = first; x < last; ++x) {
+            if (m_in_domain && !m_in_domain(x)) { continue; }
+            auto y = m_crypter.encrypt(x, tweak);
+            if (y >= m_size) {
+                out_of_table = true;
+                return;
+            }
+            tables.forward[x] = y;
+            tables.backward[y] = x;
+        }
+    };
+
+    const auto threads_cnt = static_cast<value_type>(std::max<std::size_t>(1, std::min<std::size_t>(
+            std::thread::hardware_concurrency(), m_size / MIN_VALUES_PER_THREAD)));
+    const auto chunk = m_size / threads_cnt;
+
+    std::vector<std::thread> workers;
+    for (value_type i = 1; i < threads_cnt; ++i) {
+        workers.emplace_back(fill, i * chunk, i + 1 == threads_cnt ? m_size : (i + 1) * chunk);
+    }
+    fill(0, threads_cnt > 1 ? chunk : m_size);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    if (out_of_table) {
+        throw std::logic_error("Codebook: the crypter maps the domain outside of the codebook");
+    }
+    return tables;
+}
+
+}  // namespace grafpe::crypter
@@ -7,6 +7,7 @@
 #include <memory>
 #include <cstdint>
 #include <utility>
+#include <vector>
 #include <grafpe/common/type_utils.hpp>
 #include <grafpe/crypt/utils.hpp>
 
@@ -23,6 +24,16 @@ class GraphTraverser {
     std::shared_ptr<const CryptCtx> cryptCtx;
 
  public:
+    /**
+     * A walk decoded from the random buffer. It holds the permutations
+     * applied in consecutive steps, both going forward and going back.
+     * The pointers are valid as long as the context of the traverser lives.
+     */
+    struct Walk {
+        std::vector<const point_t*> forward;
+        std::vector<const point_t*> backward;
+    };
+
     GraphTraverser(Graph &&graph, size_t walk_length)
             : cryptCtx { std::make_shared<CryptCtx>(std::move(graph), walk_length)} {
     }
@@ -30,6 +41,10 @@ class GraphTraverser {
     cell_t go(cell_t start, const vec_u8_t& B) const;
     cell_t go_back(cell_t start, const vec_u8_t& B) const;
 
+    Walk decode(const vec_u8_t& B) const;
+    cell_t go(cell_t start, const Walk& walk) const;
+    cell_t go_back(cell_t start, const Walk& walk) const;
+
     const CryptCtx& getContext() const {
         return *cryptCtx;
     }
@@ -0,0 +1,138 @@
+/*
+ * author: Adam Budziak
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+
+#include <grafpe/aes/openssl/AesCtr128PRNG.hpp>
+#include "Crypter.hpp"
+#include "Grafpe.hpp"
+
+namespace grafpe::crypter {
+
+/**
+ * Zn <=> Zn encryption of single values for domains too large for a graph of N vertices.
+ *
+ * A value is split into d digits in the base b, the smallest base with b^d >= N
+ * for the least d keeping b <= max_base, and the digit vector is encrypted
+ * with the vector Grafpe over a graph of just b vertices.
+ * Digit vectors above N - 1 are cycle-walked (compared from the top digit),
+ * which on average takes less than 1 + d / b encryptions.
+ *
+ * Meant for the ranks of large RTE formats (see rte::DFA).
+ */
+template<typename prng_engine_t = aes::openssl::AesCtr128PRNG>
+class RadixGrafpe: public Base<typename perm_t::value_type> {
+ public:
+    using value_type = typename perm_t::value_type;
+    using key_type = typename Grafpe<prng_engine_t>::key_type;
+    using iv_type = typename Grafpe<prng_engine_t>::iv_type;
+
+    static constexpr point_t DEFAULT_MAX_BASE = 1u << 16u;
+
+ private:
+    value_type m_size;
+    std::size_t m_digits;
+    point_t m_base;
+    perm_t m_max_digits;
+    Grafpe<prng_engine_t> m_grafpe;
+
+ public:
+    RadixGrafpe(key_type key, iv_type iv, value_type N, std::size_t D, std::size_t walk_length,
+                point_t max_base = DEFAULT_MAX_BASE)
+      : m_size {N},
+        m_digits {digits_count(N, max_base)},
+        m_base {smallest_base(N, m_digits)},
+        m_max_digits {split(N - 1)},
+        m_grafpe {std::move(key), std::move(iv), m_base, D, walk_length} {  }
+
+    value_type size() const noexcept { return m_size; }
+    std::size_t digits() const noexcept { return m_digits; }
+    point_t base() const noexcept { return m_base; }
+
+ private:
+    value_type encrypt_impl(const value_type& value, const tweak_t& tweak) const override {
+        return walk(value, [this, &tweak](const perm_t& digits) { return m_grafpe.encrypt(digits, tweak); });
+    }
+
+    value_type decrypt_impl(const value_type& value, const tweak_t& tweak) const override {
+        return walk(value, [this, &tweak](const perm_t& digits) { return m_grafpe.decrypt(digits, tweak); });
+    }
+
+    template <typename Step_F>
+    value_type walk(const value_type& value, Step_F step) const {
+        if (value >= m_size) {
+            throw std::out_of_range("RadixGrafpe: value outside of the domain");
+        }
+        auto digits = split(value);
+        do {
+            digits = step(digits);
+        } while (!in_domain(digits));
+        return join(digits);
+    }
+
+    // the most significant digit goes first
+    perm_t split(value_type value) const {
+        perm_t digits(m_digits);
+        for (auto i = m_digits; i-- > 0;) {
+            digits[i] = value % m_base;
+            value /= m_base;
+        }
+        return digits;
+    }
+
+    value_type join(const perm_t& digits) const noexcept {
+        value_type value = 0;
+        for (auto digit : digits) {
+            value = value * m_base + digit;
+        }
+        return value;
+    }
+
+    // b^d may not fit in 64 bits, so the digits are compared instead of the values
+    bool in_domain(const perm_t& digits) const noexcept {
+        return digits <= m_max_digits;
+    }
+
+    static bool power_covers(point_t base, std::size_t exponent, value_type N) noexcept {
+        const auto quotient = N / base + (N % base != 0);
+        value_type power = 1;
+        for (std::size_t i = 0; i < exponent; ++i) {
+            // power * base >= N, without overflowing
+            if (power >= quotient) { return true; }
+            power *= base;
+        }
+        return power >= N;
+    }
+
+    static std::size_t digits_count(value_type N, point_t max_base) {
+        if (N < 2 || max_base < 2) {
+            throw std::invalid_argument("RadixGrafpe: the domain and the base have to have at least 2 values");
+        }
+        std::size_t digits = 1;
+        while (!power_covers(max_base, digits, N)) {
+            ++digits;
+        }
+        return digits;
+    }
+
+    static point_t smallest_base(value_type N, std::size_t digits) noexcept {
+        point_t low = 2, high = 2;
+        while (!power_covers(high, digits, N)) {
+            low = high;
+            high *= 2;
+        }
+        // power_covers(high) holds, binary search for the smallest such base
+        while (low < high) {
+            auto mid = low + (high - low) / 2;
+            if (power_covers(mid, digits, N)) { high = mid; } else { low = mid + 1; }
+        }
+        return high;
+    }
+};
+
+}  // namespace grafpe::crypter
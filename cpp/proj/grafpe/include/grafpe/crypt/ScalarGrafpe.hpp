@@ -4,74 +4,160 @@
 
 #pragma once
 
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include <pur/containers/lru_cache.hpp>
 #include <grafpe/aes/openssl/AesCtr128PRNG.hpp>
 #include <grafpe/graph/GraphBuilder.hpp>
 #include <grafpe/crypt/Crypter.hpp>
+#include <grafpe/crypt/simd.hpp>
 #include "GraphTraverser.hpp"
 
 namespace grafpe::crypter {
 
+/**
+ * Zn <=> Zn encryption of single values.
+ *
+ * The walk performed by the crypter depends only on the tweak, so the decoded
+ * walks are kept in a bounded cache shared by all copies of the crypter.
+ * Encryption under a cached tweak doesn't touch the PRNG at all.
+ *
+ * Since all the values encrypted under one tweak share the walk, batches of values
+ * are walked in lockstep with vector gathers (see simd::walk).
+ */
 template <typename prng_engine_t = aes::openssl::AesCtr128PRNG>
 class ScalarGrafpe: public Base<typename perm_t::value_type> {
     using ctx_t = typename prng_engine_t::ctx_type;
+    using walk_cache_t = pur::lru_cache<uint64_t, GraphTraverser::Walk>;
 
  public:
     using key_type = typename ctx_t::key_type;
     using iv_type = typename ctx_t::iv_type;
     using value_type = typename perm_t::value_type;
 
+    static constexpr std::size_t DEFAULT_WALK_CACHE_CAPACITY = 1024;
+
  private:
     GraphTraverser traverser;
     key_type key;
+    std::shared_ptr<walk_cache_t> walks;
 
  public:
-    ScalarGrafpe(Graph graph, size_t walk_length, key_type key)
+    ScalarGrafpe(Graph graph, size_t walk_length, key_type key,
+                 std::size_t walk_cache_capacity = DEFAULT_WALK_CACHE_CAPACITY)
       : traverser{ std::move(graph), walk_length },
-        key { std::move(key) } {}
+        key { std::move(key) },
+        walks { std::make_shared<walk_cache_t>(walk_cache_capacity) } {}
 
-    ScalarGrafpe(key_type key, iv_type iv, point_t N, std::size_t D, std::size_t walk_length)
+    ScalarGrafpe(key_type key, iv_type iv, point_t N, std::size_t D, std::size_t walk_length,
+                 std::size_t walk_cache_capacity = DEFAULT_WALK_CACHE_CAPACITY)
       : traverser{GraphBuilder<prng_engine_t>::create_from_engine({key, iv}).build(N, D), walk_length},
-        key { std::move(key) } {  }
+        key { std::move(key) },
+        walks { std::make_shared<walk_cache_t>(walk_cache_capacity) } {  }
 
     std::size_t size() const noexcept { return traverser.getContext().n; }
 
+    /**
+     * Statistics of the tweak -> walk cache, shared by all copies of the crypter.
+     */
+    pur::cache_statistics walk_cache_stats() const { return walks->stats(); }
+
+    /**
+     * Encrypts `count` values under the same tweak, equivalent to calling encrypt for each of them.
+     * `in` and `out` may be the same buffer.
+     */
+    void encrypt_batch(const value_type* in, value_type* out, std::size_t count,
+                       const tweak_t& tweak = {}, simd::isa instruction_set = simd::best_supported()) const;
+
+    /**
+     * Decrypts `count` values under the same tweak, equivalent to calling decrypt for each of them.
+     * `in` and `out` may be the same buffer.
+     */
+    void decrypt_batch(const value_type* in, value_type* out, std::size_t count,
+                       const tweak_t& tweak = {}, simd::isa instruction_set = simd::best_supported()) const;
+
+    std::vector<value_type> encrypt_batch(const std::vector<value_type>& values, const tweak_t& tweak = {}) const {
+        std::vector<value_type> result(values.size());
+        encrypt_batch(values.data(), result.data(), values.size(), tweak);
+        return result;
+    }
+
+    std::vector<value_type> decrypt_batch(const std::vector<value_type>& values, const tweak_t& tweak = {}) const {
+        std::vector<value_type> result(values.size());
+        decrypt_batch(values.data(), result.data(), values.size(), tweak);
+        return result;
+    }
+
  private:
     point_t encrypt_impl(const point_t& msg, const tweak_t& tweak) const override;
     point_t decrypt_impl(const point_t& cipher, const tweak_t& tweak) const override;
+
+    typename walk_cache_t::value_ptr get_walk(const tweak_t& tweak) const;
 };
 
 
 
 template<typename prng_engine_t>
 point_t ScalarGrafpe<prng_engine_t>::encrypt_impl(const point_t& msg, const tweak_t &tweak) const {
-    key_type key_ {};
-    iv_type iv {};
+    const auto walk = get_walk(tweak);
 
-    point_t absorbed = 0;
+    point_t absorbed = traverser.go(msg % traverser.getContext().n, *walk);
+    return traverser.go(absorbed % traverser.getContext().n, *walk);
+}
 
-    vec_u8_t random(traverser.getContext().walk_length * (traverser.getContext().f + 1));
 
-    generate_key_iv<ctx_t>({0}, tweak, key_, iv);
-    prng_engine_t{key, iv}.fill_bytes(random);
+template<typename prng_engine_t>
+point_t ScalarGrafpe<prng_engine_t>::decrypt_impl(const point_t& cipher, const tweak_t &tweak) const {
+    const auto walk = get_walk(tweak);
 
-    absorbed = traverser.go(msg % traverser.getContext().n, random);
-    return traverser.go(absorbed % traverser.getContext().n, random);
+    point_t absorbed = traverser.go_back(cipher, *walk);
+    return traverser.go_back(absorbed, *walk);
 }
 
 
 template<typename prng_engine_t>
-point_t ScalarGrafpe<prng_engine_t>::decrypt_impl(const point_t& cipher, const tweak_t &tweak) const {
+void ScalarGrafpe<prng_engine_t>::encrypt_batch(const value_type* in, value_type* out, std::size_t count,
+                                                const tweak_t& tweak, simd::isa instruction_set) const {
+    const auto walk = get_walk(tweak);
+    const auto n = traverser.getContext().n;
+
+    for (std::size_t i = 0; i < count; ++i) {
+        out[i] = in[i] % n;
+    }
+    // the walk always ends inside Zn, so the second reduction is not needed
+    simd::walk(walk->forward.data(), walk->forward.size(), out, count, instruction_set);
+    simd::walk(walk->forward.data(), walk->forward.size(), out, count, instruction_set);
+}
+
+
+template<typename prng_engine_t>
+void ScalarGrafpe<prng_engine_t>::decrypt_batch(const value_type* in, value_type* out, std::size_t count,
+                                                const tweak_t& tweak, simd::isa instruction_set) const {
+    const auto walk = get_walk(tweak);
+
+    std::copy(in, in + count, out);
+    simd::walk(walk->backward.data(), walk->backward.size(), out, count, instruction_set);
+    simd::walk(walk->backward.data(), walk->backward.size(), out, count, instruction_set);
+}
+
+
+template<typename prng_engine_t>
+auto ScalarGrafpe<prng_engine_t>::get_walk(const tweak_t &tweak) const -> typename walk_cache_t::value_ptr {
+    if (auto walk = walks->find(*tweak.data())) {
+        return walk;
+    }
+
     key_type key_ {};
     iv_type iv {};
-    point_t absorbed = 0;
 
     vec_u8_t random(traverser.getContext().walk_length * (traverser.getContext().f + 1));
 
     generate_key_iv<ctx_t>({0}, tweak, key_, iv);
     prng_engine_t{key, iv}.fill_bytes(random);
 
-    absorbed = traverser.go_back(cipher, random);
-    return traverser.go_back(absorbed, random);
+    return walks->insert(*tweak.data(), traverser.decode(random));
 }
 
 template<typename Crypter>
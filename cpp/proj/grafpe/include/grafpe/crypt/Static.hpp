@@ -0,0 +1,223 @@
+/*
+ * author: Adam Budziak
+ */
+
+#pragma once
+
+#include <type_traits>
+#include <utility>
+
+#include "Crypter.hpp"
+#include "batch.hpp"
+
+namespace grafpe::crypter {
+
+/**
+ * Compile-time counterpart of Base.
+ *
+ * The derived crypter provides (possibly private, then StaticBase has to be its friend)
+ * non-virtual encrypt_impl and decrypt_impl, which are called directly, so a stack
+ * of static crypters can be inlined into a single call. Use Dynamic to put such
+ * a stack behind the virtual interface.
+ *
+ * @tparam Derived_T - the crypter deriving from StaticBase
+ */
+template <typename Derived_T, typename Value_T>
+class StaticBase {
+ public:
+    using value_type = Value_T;
+
+    [[nodiscard]]
+    value_type encrypt(const value_type& value) const {
+        return derived().encrypt_impl(value, {});
+    }
+
+    [[nodiscard]]
+    value_type decrypt(const value_type& value) const {
+        return derived().decrypt_impl(value, {});
+    }
+
+    [[nodiscard]]
+    value_type encrypt(const value_type& value, const tweak_t& tweak) const {
+        return derived().encrypt_impl(value, tweak);
+    }
+
+    [[nodiscard]]
+    value_type decrypt(const value_type& value, const tweak_t& tweak) const {
+        return derived().decrypt_impl(value, tweak);
+    }
+
+ protected:
+    StaticBase() = default;
+    ~StaticBase() = default;
+
+ private:
+    const Derived_T& derived() const noexcept { return static_cast<const Derived_T&>(*this); }
+};
+
+
+/**
+ * CastCrypter with the cast and uncast given as function objects instead of virtual methods.
+ *
+ * The value type is deduced from the result of the uncast, e.g.
+ * StaticCastCrypter{grafpe, [](uint32_t x) { return point_t{x}; }, [](point_t x) { return uint32_t(x); }}
+ */
+template <typename Crypter_T, typename Value_T, typename Cast_F, typename Uncast_F>
+class StaticCastCrypter: public StaticBase<StaticCastCrypter<Crypter_T, Value_T, Cast_F, Uncast_F>, Value_T> {
+    friend StaticBase<StaticCastCrypter, Value_T>;
+
+    using crypter_value_t = typename Crypter_T::value_type;
+    Crypter_T m_crypter;
+    Cast_F m_cast;
+    Uncast_F m_uncast;
+
+ public:
+    using value_type = Value_T;
+
+    StaticCastCrypter(Crypter_T crypter, Cast_F cast, Uncast_F uncast)
+      : m_crypter {std::move(crypter)}, m_cast {std::move(cast)}, m_uncast {std::move(uncast)} {  }
+
+    crypter_value_t cast(const value_type& value) const {
+        return m_cast(value);
+    }
+
+    value_type uncast(const crypter_value_t& value) const {
+        return m_uncast(value);
+    }
+
+    /**
+     * Encrypts `count` values under the same tweak.
+     * @see CastCrypter::encrypt_batch
+     */
+    void encrypt_batch(const value_type* in, value_type* out, std::size_t count, const tweak_t& tweak = {}) const {
+        cast_batch(in, out, count, [this, &tweak](const crypter_value_t* values, crypter_value_t* result, std::size_t n) {
+            crypter::encrypt_batch(m_crypter, values, result, n, tweak);
+        });
+    }
+
+    /**
+     * Decrypts `count` values under the same tweak.
+     * @see CastCrypter::encrypt_batch
+     */
+    void decrypt_batch(const value_type* in, value_type* out, std::size_t count, const tweak_t& tweak = {}) const {
+        cast_batch(in, out, count, [this, &tweak](const crypter_value_t* values, crypter_value_t* result, std::size_t n) {
+            crypter::decrypt_batch(m_crypter, values, result, n, tweak);
+        });
+    }
+
+ private:
+    value_type encrypt_impl(const value_type& value, const tweak_t& tweak) const {
+        return m_uncast(m_crypter.encrypt(m_cast(value), tweak));
+    }
+
+    value_type decrypt_impl(const value_type& value, const tweak_t& tweak) const {
+        return m_uncast(m_crypter.decrypt(m_cast(value), tweak));
+    }
+
+    template <typename Batch_F>
+    void cast_batch(const value_type* in, value_type* out, std::size_t count, Batch_F batch) const {
+        crypter::cast_batch<crypter_value_t>(in, out, count,
+                [this](const auto& value) { return m_cast(value); },
+                batch,
+                [this](const crypter_value_t& value, value_type& result) { result = m_uncast(value); });
+    }
+};
+
+template <typename Crypter_T, typename Cast_F, typename Uncast_F>
+StaticCastCrypter(Crypter_T, Cast_F, Uncast_F) -> StaticCastCrypter<Crypter_T,
+        std::decay_t<std::invoke_result_t<Uncast_F, const typename Crypter_T::value_type&>>, Cast_F, Uncast_F>;
+
+
+/**
+ * Targeted crypter dispatching statically, both to the targeter and to the crypter.
+ *
+ * Together with a targeter keeping the exact type of its predicate
+ * (see domain::targeting::make_cycle_walker) the whole walk can be inlined.
+ */
+template <typename Targeter_T, typename Crypter_T>
+class StaticTargeted: public StaticBase<StaticTargeted<Targeter_T, Crypter_T>, typename Targeter_T::value_type> {
+    friend StaticBase<StaticTargeted, typename Targeter_T::value_type>;
+
+    Targeter_T targeter;
+    Crypter_T crypter;
+
+ public:
+    using value_type = typename Targeter_T::value_type;
+
+    StaticTargeted(Targeter_T targeter, Crypter_T crypter)
+      : targeter { std::move(targeter) }, crypter { std::move(crypter) } {  }
+
+    /**
+     * Encrypts `count` values under the same tweak.
+     * @see Targeted::encrypt_batch
+     */
+    void encrypt_batch(const value_type* in, value_type* out, std::size_t count, const tweak_t& tweak = {}) const {
+        if constexpr (has_batch_targeter_v<Targeter_T, Crypter_T>) {
+            targeter.encrypt_batch(crypter, in, out, count, tweak);
+        } else {
+            for (std::size_t i = 0; i < count; ++i) {
+                out[i] = targeter.encrypt(crypter, in[i], tweak);
+            }
+        }
+    }
+
+    /**
+     * Decrypts `count` values under the same tweak.
+     * @see Targeted::encrypt_batch
+     */
+    void decrypt_batch(const value_type* in, value_type* out, std::size_t count, const tweak_t& tweak = {}) const {
+        if constexpr (has_batch_targeter_v<Targeter_T, Crypter_T>) {
+            targeter.decrypt_batch(crypter, in, out, count, tweak);
+        } else {
+            for (std::size_t i = 0; i < count; ++i) {
+                out[i] = targeter.decrypt(crypter, in[i], tweak);
+            }
+        }
+    }
+
+ private:
+    value_type encrypt_impl(const value_type& value, const tweak_t& tweak) const {
+        return targeter.encrypt(crypter, value, tweak);
+    }
+
+    value_type decrypt_impl(const value_type& value, const tweak_t& tweak) const {
+        return targeter.decrypt(crypter, value, tweak);
+    }
+};
+
+
+/**
+ * Puts a statically composed crypter behind the virtual interface,
+ * so it can be composed at runtime with other crypters.
+ * The whole wrapped stack costs a single virtual call.
+ */
+template <typename Crypter_T>
+class Dynamic final: public Base<typename Crypter_T::value_type> {
+    Crypter_T m_crypter;
+
+ public:
+    using value_type = typename Crypter_T::value_type;
+
+    explicit Dynamic(Crypter_T crypter): m_crypter {std::move(crypter)} {  }
+
+    [[nodiscard]] const Crypter_T& crypter() const noexcept { return m_crypter; }
+
+    void encrypt_batch(const value_type* in, value_type* out, std::size_t count, const tweak_t& tweak = {}) const {
+        crypter::encrypt_batch(m_crypter, in, out, count, tweak);
+    }
+
+    void decrypt_batch(const value_type* in, value_type* out, std::size_t count, const tweak_t& tweak = {}) const {
+        crypter::decrypt_batch(m_crypter, in, out, count, tweak);
+    }
+
+ private:
+    value_type encrypt_impl(const value_type& value, const tweak_t& tweak) const override {
+        return m_crypter.encrypt(value, tweak);
+    }
+
+    value_type decrypt_impl(const value_type& value, const tweak_t& tweak) const override {
+        return m_crypter.decrypt(value, tweak);
+    }
+};
+
+}  // namespace grafpe::crypter
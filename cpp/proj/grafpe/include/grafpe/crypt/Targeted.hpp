@@ -5,7 +5,10 @@
 #pragma once
 
 #include <memory>
+#include <type_traits>
+#include <vector>
 #include <grafpe/crypt/Crypter.hpp>
+#include <grafpe/crypt/batch.hpp>
 #include <grafpe/common/type_utils.hpp>
 
 namespace grafpe::crypter {
@@ -23,6 +26,31 @@ class Targeted : public Base<typename Crypter_T::value_type> {
     : targeter { std::move(targeter) }, crypter { std::move(crypter) }
     {  }
 
+    /**
+     * Encrypts `count` values under the same tweak, equivalent to calling encrypt for each of them.
+     * Uses the batch API of the targeter when it has one (e.g. CycleWalker).
+     * `in` and `out` may be the same buffer.
+     */
+    void encrypt_batch(const value_type* in, value_type* out, std::size_t count, const tweak_t& tweak = {}) const;
+
+    /**
+     * Decrypts `count` values under the same tweak, equivalent to calling decrypt for each of them.
+     * @see encrypt_batch
+     */
+    void decrypt_batch(const value_type* in, value_type* out, std::size_t count, const tweak_t& tweak = {}) const;
+
+    std::vector<value_type> encrypt_batch(const std::vector<value_type>& values, const tweak_t& tweak = {}) const {
+        std::vector<value_type> result(values.size());
+        encrypt_batch(values.data(), result.data(), values.size(), tweak);
+        return result;
+    }
+
+    std::vector<value_type> decrypt_batch(const std::vector<value_type>& values, const tweak_t& tweak = {}) const {
+        std::vector<value_type> result(values.size());
+        decrypt_batch(values.data(), result.data(), values.size(), tweak);
+        return result;
+    }
+
  private:
     constexpr value_type encrypt_impl(const value_type& value, const tweak_t& tweak) const override;
     constexpr value_type decrypt_impl(const value_type& value, const tweak_t& tweak) const override;
@@ -42,4 +70,28 @@ const -> value_type {
     return targeter.decrypt(crypter, value, tweak);
 }
 
+template<typename Targeter_T, typename Crypter_T>
+void Targeted<Targeter_T, Crypter_T>::encrypt_batch(const value_type* in, value_type* out, std::size_t count,
+                                                    const tweak_t& tweak) const {
+    if constexpr (has_batch_targeter_v<Targeter_T, Crypter_T>) {
+        targeter.encrypt_batch(crypter, in, out, count, tweak);
+    } else {
+        for (std::size_t i = 0; i < count; ++i) {
+            out[i] = targeter.encrypt(crypter, in[i], tweak);
+        }
+    }
+}
+
+template<typename Targeter_T, typename Crypter_T>
+void Targeted<Targeter_T, Crypter_T>::decrypt_batch(const value_type* in, value_type* out, std::size_t count,
+                                                    const tweak_t& tweak) const {
+    if constexpr (has_batch_targeter_v<Targeter_T, Crypter_T>) {
+        targeter.decrypt_batch(crypter, in, out, count, tweak);
+    } else {
+        for (std::size_t i = 0; i < count; ++i) {
+            out[i] = targeter.decrypt(crypter, in[i], tweak);
+        }
+    }
+}
+
 }  // namespace grafpe::crypter
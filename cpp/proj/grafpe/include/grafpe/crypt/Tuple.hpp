@@ -4,11 +4,16 @@
 
 #pragma once
 
+#include <exception>
 #include <memory>
+#include <stdexcept>
+#include <thread>
 #include <tuple>
 #include <functional>
+#include <vector>
 
 #include <grafpe/crypt/Crypter.hpp>
+#include <grafpe/crypt/batch.hpp>
 
 namespace grafpe::crypter {
 
@@ -54,11 +59,18 @@ namespace detail {
 /**
  * Crypter class used for encryption of whole datarows.
  *
+ * Besides row by row, tables can be encrypted column by column (struct-of-arrays):
+ * every column goes to its crypter as a single batch, so the crypters with a batch API
+ * (e.g. ScalarGrafpe, or rte crypters casting to it) encrypt it at their batch speed.
+ * The columns can be processed on separate threads, the crypters have to be thread-safe then.
  */
 template <typename ...Crypters>
 class Tuple: public Base<std::tuple<typename Crypters::value_type...>> {
  public:
     using value_type = std::tuple<typename Crypters::value_type...>;
+    using columns_type = std::tuple<const typename Crypters::value_type*...>;
+    using output_columns_type = std::tuple<typename Crypters::value_type*...>;
+    using table_type = std::tuple<std::vector<typename Crypters::value_type>...>;
 
     explicit Tuple(Crypters... crypters) noexcept : m_crypters {std::move(crypters)...}
     {  }
@@ -76,7 +88,97 @@ class Tuple: public Base<std::tuple<typename Crypters::value_type...>> {
         return decrypt(std::make_tuple(params...));
     }
 
+    /**
+     * Encrypts a table of `rows` rows given as one array per column, under the same tweak.
+     * The result is the same as encrypting the rows one by one.
+     * The input and output columns may be the same arrays.
+     *
+     * @param parallel - whether every column is encrypted on its own thread
+     */
+    void encrypt_columns(const columns_type& in, const output_columns_type& out, std::size_t rows,
+                         const tweak_t& tweak = {}, bool parallel = false) const {
+        for_each_column([&](auto column) {
+            constexpr auto I = decltype(column)::value;
+            crypter::encrypt_batch(std::get<I>(m_crypters), std::get<I>(in), std::get<I>(out), rows, tweak);
+        }, parallel);
+    }
+
+    /**
+     * Decrypts a table given as one array per column.
+     * @see encrypt_columns
+     */
+    void decrypt_columns(const columns_type& in, const output_columns_type& out, std::size_t rows,
+                         const tweak_t& tweak = {}, bool parallel = false) const {
+        for_each_column([&](auto column) {
+            constexpr auto I = decltype(column)::value;
+            crypter::decrypt_batch(std::get<I>(m_crypters), std::get<I>(in), std::get<I>(out), rows, tweak);
+        }, parallel);
+    }
+
+    [[nodiscard]]
+    table_type encrypt_columns(const table_type& table, const tweak_t& tweak = {}, bool parallel = false) const {
+        table_type result = resized_like(table);
+        encrypt_columns(data_of(table), data_of(result), std::get<0>(table).size(), tweak, parallel);
+        return result;
+    }
+
+    [[nodiscard]]
+    table_type decrypt_columns(const table_type& table, const tweak_t& tweak = {}, bool parallel = false) const {
+        table_type result = resized_like(table);
+        decrypt_columns(data_of(table), data_of(result), std::get<0>(table).size(), tweak, parallel);
+        return result;
+    }
+
  private:
+    using indices_t = std::make_index_sequence<sizeof ...(Crypters)>;
+
+    template <typename Column_F>
+    void for_each_column(Column_F process, bool parallel) const {
+        for_each_column(process, parallel, indices_t{});
+    }
+
+    template <typename Column_F, std::size_t ...I>
+    void for_each_column(Column_F process, bool parallel, std::index_sequence<I...>) const {
+        if (!parallel) {
+            (process(std::integral_constant<std::size_t, I>{}), ...);
+            return;
+        }
+
+        // the first error is rethrown once all the columns are done
+        std::vector<std::exception_ptr> errors(sizeof...(Crypters));
+        std::vector<std::thread> workers;
+        (workers.emplace_back([&process, &errors] {
+            try {
+                process(std::integral_constant<std::size_t, I>{});
+            } catch (...) {
+                errors[I] = std::current_exception();
+            }
+        }), ...);
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        for (auto& error : errors) {
+            if (error) { std::rethrow_exception(error); }
+        }
+    }
+
+    static table_type resized_like(const table_type& table) {
+        const auto rows = std::get<0>(table).size();
+        table_type result;
+        std::apply([rows](const auto& ...columns) {
+            if (((columns.size() != rows) || ...)) {
+                throw std::invalid_argument("Tuple: all the columns have to have the same length");
+            }
+        }, table);
+        std::apply([rows](auto& ...columns) { (columns.resize(rows), ...); }, result);
+        return result;
+    }
+
+    template <typename Table_T>
+    static auto data_of(Table_T& table) {
+        return std::apply([](auto& ...columns) { return std::make_tuple(columns.data()...); }, table);
+    }
+
     constexpr value_type encrypt_impl(const value_type& tup, const tweak_t& tweak) const override {
         return detail::encrypt_impl(m_crypters, tup, typename std::make_index_sequence<sizeof ...(Crypters)>(), tweak);
     }
@@ -0,0 +1,119 @@
+/*
+ * author: Adam Budziak
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "../common/type_utils.hpp"
+
+namespace grafpe::crypter {
+
+/**
+ * Checks whether the crypter has its own encrypt_batch/decrypt_batch
+ * working on contiguous buffers of values (e.g. ScalarGrafpe).
+ */
+template <typename Crypter_T, typename = void>
+struct has_batch : std::false_type {};
+
+template <typename Crypter_T>
+struct has_batch<Crypter_T, std::void_t<
+        decltype(std::declval<const Crypter_T&>().encrypt_batch(
+                std::declval<const typename Crypter_T::value_type*>(),
+                std::declval<typename Crypter_T::value_type*>(),
+                std::size_t{}, std::declval<const tweak_t&>())),
+        decltype(std::declval<const Crypter_T&>().decrypt_batch(
+                std::declval<const typename Crypter_T::value_type*>(),
+                std::declval<typename Crypter_T::value_type*>(),
+                std::size_t{}, std::declval<const tweak_t&>()))>> : std::true_type {};
+
+template <typename Crypter_T>
+inline constexpr bool has_batch_v = has_batch<Crypter_T>::value;
+
+/**
+ * Checks whether the targeter (e.g. CycleWalker) can walk whole batches of values
+ * over the crypter.
+ */
+template <typename Targeter_T, typename Crypter_T, typename = void>
+struct has_batch_targeter : std::false_type {};
+
+template <typename Targeter_T, typename Crypter_T>
+struct has_batch_targeter<Targeter_T, Crypter_T, std::void_t<
+        decltype(std::declval<const Targeter_T&>().encrypt_batch(
+                std::declval<const Crypter_T&>(),
+                std::declval<const typename Crypter_T::value_type*>(),
+                std::declval<typename Crypter_T::value_type*>(),
+                std::size_t{}, std::declval<const tweak_t&>()))>> : std::true_type {};
+
+template <typename Targeter_T, typename Crypter_T>
+inline constexpr bool has_batch_targeter_v = has_batch_targeter<Targeter_T, Crypter_T>::value;
+
+/**
+ * Encrypts `count` values with the batch API of the crypter,
+ * or value by value if the crypter doesn't have one.
+ * `in` and `out` may be the same buffer.
+ */
+template <typename Crypter_T, typename Value_T>
+void encrypt_batch(const Crypter_T& crypter, const Value_T* in, Value_T* out,
+                   std::size_t count, const tweak_t& tweak = {}) {
+    if constexpr (has_batch_v<Crypter_T>) {
+        crypter.encrypt_batch(in, out, count, tweak);
+    } else {
+        for (std::size_t i = 0; i < count; ++i) {
+            out[i] = crypter.encrypt(in[i], tweak);
+        }
+    }
+}
+
+/**
+ * Decrypts `count` values with the batch API of the crypter,
+ * or value by value if the crypter doesn't have one.
+ * `in` and `out` may be the same buffer.
+ */
+template <typename Crypter_T, typename Value_T>
+void decrypt_batch(const Crypter_T& crypter, const Value_T* in, Value_T* out,
+                   std::size_t count, const tweak_t& tweak = {}) {
+    if constexpr (has_batch_v<Crypter_T>) {
+        crypter.decrypt_batch(in, out, count, tweak);
+    } else {
+        for (std::size_t i = 0; i < count; ++i) {
+            out[i] = crypter.decrypt(in[i], tweak);
+        }
+    }
+}
+
+/**
+ * Number of values cast at once by cast_batch, bounding its scratch buffer.
+ */
+inline constexpr std::size_t BATCH_CHUNK = 1024;
+
+/**
+ * Runs `batch` over values converted to the crypter domain, chunk by chunk.
+ *
+ * Every value of `in` goes through `cast`, each chunk of at most BATCH_CHUNK
+ * cast values is handed to `batch(values, result, n)` in place,
+ * and `uncast(value, out[i])` writes the results back.
+ */
+template <typename Crypter_value_T, typename In_T, typename Out_T,
+          typename Cast_F, typename Batch_F, typename Uncast_F>
+void cast_batch(const In_T* in, Out_T* out, std::size_t count,
+                Cast_F&& cast, Batch_F&& batch, Uncast_F&& uncast) {
+    std::vector<Crypter_value_T> values(std::min(count, BATCH_CHUNK));
+    for (std::size_t first = 0; first < count; first += BATCH_CHUNK) {
+        const auto n = std::min(BATCH_CHUNK, count - first);
+        for (std::size_t i = 0; i < n; ++i) {
+            values[i] = cast(in[first + i]);
+        }
+        batch(values.data(), values.data(), n);
+        for (std::size_t i = 0; i < n; ++i) {
+            uncast(values[i], out[first + i]);
+        }
+    }
+}
+
+}  // namespace grafpe::crypter
@@ -0,0 +1,59 @@
+/*
+ * author: Adam Budziak
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include <grafpe/common/type_utils.hpp>
+
+namespace grafpe::simd {
+
+/**
+ * Instruction sets the batch walks can be performed with.
+ */
+enum class isa {
+    scalar,
+    avx2,
+    avx512
+};
+
+const char* to_string(isa instruction_set) noexcept;
+
+/**
+ * Checks (at runtime) whether the current CPU supports the instruction set.
+ */
+bool is_supported(isa instruction_set) noexcept;
+
+/**
+ * The widest instruction set supported by the current CPU, detected once.
+ */
+isa best_supported() noexcept;
+
+/**
+ * All instruction sets supported by the current CPU.
+ */
+std::vector<isa> all_supported();
+
+/**
+ * Performs the same walk for `count` values in lockstep.
+ *
+ * The walk is a sequence of permutations (given as pointers to their tables);
+ * in every step each of the values is replaced with its image under the current permutation.
+ * The values have to be valid indices of the permutations.
+ *
+ * The values are walked in blocks of 16 (AVX2) or 32 (AVX-512): every step of a block
+ * is 4 independent gathers of 4 or 8 values, so that their latencies overlap.
+ *
+ * @param steps - permutations applied in consecutive steps
+ * @param steps_cnt - length of the walk
+ * @param values - values walked in place
+ * @param count - number of the values
+ * @param instruction_set - has to be supported by the CPU, std::invalid_argument is thrown otherwise
+ */
+void walk(const point_t* const* steps, std::size_t steps_cnt,
+          point_t* values, std::size_t count, isa instruction_set = best_supported());
+
+}  // namespace grafpe::simd
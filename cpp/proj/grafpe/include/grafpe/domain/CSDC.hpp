@@ -5,21 +5,48 @@
 #pragma once
 
 #include <functional>
+#include <utility>
 
 #include <grafpe/domain/CycleSlicer.hpp>
 
 namespace grafpe::domain::extension {
 
-template<typename Crypter_T, typename PRNG_T>
-class CSDC : public grafpe::domain::targeting::MultiRoundsDT<Crypter_T> {
+/**
+ * Domain completion with a CycleSlicer.
+ *
+ * The inclusion and map functions are std::functions by default; giving their types
+ * explicitly lets the compiler inline them, together with the CycleSlicer, into the rounds.
+ */
+template<typename Crypter_T, typename PRNG_T,
+         typename Incl_F = std::function<bool(const typename Crypter_T::value_type &)>,
+         typename Map_F = std::function<typename Crypter_T::value_type(const typename Crypter_T::value_type &,
+                                                                       const tweak_t &)>>
+class CSDC : public grafpe::domain::targeting::MultiRoundsDT<CSDC<Crypter_T, PRNG_T, Incl_F, Map_F>, Crypter_T> {
+    using Self = CSDC<Crypter_T, PRNG_T, Incl_F, Map_F>;
+    friend targeting::MultiRoundsDT<Self, Crypter_T>;
+
 public:
     using value_type = typename Crypter_T::value_type;
-    using incl_fn = std::function<bool(const value_type &)>;
-    using map_fn = std::function<value_type(const value_type &, const tweak_t &)>;
+    using incl_fn = Incl_F;
+    using map_fn = Map_F;
 
     using key_type = typename PRNG_T::key_type;
     using iv_type = typename PRNG_T::iv_type;
 
+    /**
+     * Inclusion Function of the CycleSlicer: both values are outside of the target.
+     * Keeps its own copy of the target inclusion function, so that CSDC can be copied.
+     */
+    struct outside_target {
+        incl_fn target_incl_fn;
+
+        bool operator()(const value_type &a, const value_type &b) const {
+            return !target_incl_fn(a) && !target_incl_fn(b);
+        }
+    };
+
+    using CycleSlicer_T = grafpe::domain::targeting::CycleSlicer<Crypter_T, PRNG_T, outside_target>;
+
 private:
     incl_fn source_incl_fn;         // T in the source material
     incl_fn target_incl_fn;         // U in the source material
@@ -27,7 +54,6 @@ private:
     map_fn preserve_forward_fn;     // G in the source material
     map_fn preserve_bckward_fn;     // G^-1
 
-    using CycleSlicer_T = grafpe::domain::targeting::CycleSlicer<Crypter_T, PRNG_T>;
     CycleSlicer_T cycle_slicer;
 
     value_type first(value_type x, const tweak_t& tweak) const {
@@ -49,7 +75,7 @@ public:
     CSDC(map_fn preserve_forward_fn, map_fn preserve_bckward_fn,
          incl_fn source_incl_fn, incl_fn target_incl_fn,
          CycleSlicer_T cycle_slicer) :
-            targeting::MultiRoundsDT<Crypter_T>(cycle_slicer.default_rounds_cnt),
+            targeting::MultiRoundsDT<Self, Crypter_T>(cycle_slicer.get_rounds_cnt()),
             source_incl_fn{source_incl_fn},
             target_incl_fn{target_incl_fn},
             preserve_forward_fn{preserve_forward_fn},
@@ -59,24 +85,32 @@ public:
     CSDC(map_fn preserve_forward_fn, map_fn preserve_bckward_fn,
          incl_fn source_incl_fn, incl_fn target_incl_fn,
          targeting::CS_Seed seed, uint64_t default_rounds_cnt) :
-            targeting::MultiRoundsDT<Crypter_T>(default_rounds_cnt),
+            targeting::MultiRoundsDT<Self, Crypter_T>(default_rounds_cnt),
             source_incl_fn{source_incl_fn},
             target_incl_fn{target_incl_fn},
             preserve_forward_fn{preserve_forward_fn},
             preserve_bckward_fn{preserve_bckward_fn},
             cycle_slicer{std::move(seed),
-                         get_cs_incl_fn(), default_rounds_cnt} {}
+                         outside_target{this->target_incl_fn}, default_rounds_cnt} {}
+
+    /**
+     * Creates a CSDC, whose CycleSlicer runs the minimal default number of rounds
+     * that keeps the total variation distance below the threshold.
+     * The sizes are described in cycle_slicer_rounds.
+     */
+    static CSDC from_tv_threshold(map_fn preserve_forward_fn, map_fn preserve_bckward_fn,
+                                  incl_fn source_incl_fn, incl_fn target_incl_fn,
+                                  targeting::CS_Seed seed,
+                                  uint64_t s_size, uint64_t t_size, double threshold) {
+        return CSDC{std::move(preserve_forward_fn), std::move(preserve_bckward_fn),
+                    std::move(source_incl_fn), std::move(target_incl_fn),
+                    std::move(seed), cycle_slicer_rounds(s_size, t_size, threshold)};
+    }
 
 private:
 
-    typename CycleSlicer_T::incl_fn_type get_cs_incl_fn() const {
-        return [this](const value_type &a, const value_type &b) {
-            return !target_incl_fn(a) && !target_incl_fn(b);
-        };
-    }
-
     value_type encrypt_impl(const Crypter_T &crypter, value_type x,
-                            const tweak_t &tweak, std::size_t rounds) const override {
+                            const tweak_t &tweak, std::size_t rounds) const {
         if (source_incl_fn(x)) {
             return preserve_forward_fn(x, tweak);
         } else if (target_incl_fn(x)) {
@@ -86,11 +120,11 @@ private:
     }
 
     value_type decrypt_impl(const Crypter_T &crypter, value_type x,
-                            const tweak_t &tweak, std::size_t rounds) const override {
+                            const tweak_t &tweak, std::size_t rounds) const {
         if (target_incl_fn(x)) {
             return preserve_bckward_fn(x, tweak);
         } else {
-            x = cycle_slicer.decrypt(crypter, std::move(x), rounds);
+            x = cycle_slicer.decrypt(crypter, std::move(x), tweak, rounds);
             if (source_incl_fn(x)) {
                 return last(std::move(x), tweak);
             }
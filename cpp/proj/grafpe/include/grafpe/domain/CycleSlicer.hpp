@@ -12,6 +12,7 @@
 #include <grafpe/crypt/Grafpe.hpp>
 #include <grafpe/domain/utils.hpp>
 #include <grafpe/domain/MultiRoundsDT.hpp>
+#include <grafpe/domain/rounds.hpp>
 #include <grafpe/prf/RangeBoolPRF.hpp>
 
 #include <grafpe/config.hpp>
@@ -43,17 +44,23 @@ struct CS_Seed {
  *
  * CS can be also used for other purposes, which can be parametrized
  * by custom definitions of the Inclusion Function.
+ *
+ * The Inclusion Function is a std::function by default; giving its type explicitly
+ * (e.g. a lambda's, see make_cycle_slicer) lets the compiler inline it into the rounds.
  */
 template<typename Crypter_T,
-         typename PRNG_T = aes::openssl::AesCtr128PRNG>
-class CycleSlicer: public MultiRoundsDT<Crypter_T> {
-    using Self = CycleSlicer<Crypter_T, PRNG_T>;
+         typename PRNG_T = aes::openssl::AesCtr128PRNG,
+         typename Incl_F = std::function<bool(const typename Crypter_T::value_type&,
+                                              const typename Crypter_T::value_type&)>>
+class CycleSlicer: public MultiRoundsDT<CycleSlicer<Crypter_T, PRNG_T, Incl_F>, Crypter_T> {
+    using Self = CycleSlicer<Crypter_T, PRNG_T, Incl_F>;
+    friend MultiRoundsDT<Self, Crypter_T>;
 
  public:
     using value_type = typename Crypter_T::value_type;
     using   key_type = typename PRNG_T::key_type;
     using    iv_type = typename PRNG_T::iv_type;
-    using incl_fn_type = std::function<bool(const value_type&, const value_type&)>;
+    using incl_fn_type = Incl_F;
 
 
     CycleSlicer(CS_Seed seed_, incl_fn_type incl_fn)
@@ -67,7 +74,7 @@ class CycleSlicer: public MultiRoundsDT<Crypter_T> {
 
     CycleSlicer(CS_Seed seed,
                 incl_fn_type incl_func, uint64_t default_rounds_cnt)
-    : MultiRoundsDT<Crypter_T>(default_rounds_cnt),
+    : MultiRoundsDT<Self, Crypter_T>(default_rounds_cnt),
       seed { std::move(seed) }, incl_fn {std::move(incl_func)},
       dir_fn { initialize_bool_prf(seed.dir_fn_seed)},
       swp_fn { initialize_bool_prf(seed.swp_fn_seed)}{
@@ -78,6 +85,14 @@ class CycleSlicer: public MultiRoundsDT<Crypter_T> {
 
     static std::shared_ptr<Self> create_ptr(CS_Seed seed, incl_fn_type incl_fn, uint64_t rounds);
 
+    /**
+     * Creates a CycleSlicer with the minimal default number of rounds
+     * that keeps the total variation distance below the threshold.
+     * The sizes are described in cycle_slicer_rounds.
+     */
+    static Self from_tv_threshold(CS_Seed seed, incl_fn_type incl_fn,
+                                  uint64_t s_size, uint64_t t_size, double threshold);
+
  private:
     CS_Seed seed;
     incl_fn_type incl_fn;
@@ -97,15 +112,15 @@ class CycleSlicer: public MultiRoundsDT<Crypter_T> {
             const tweak_t& tweak, uint64_t round_num) const;
 
     value_type encrypt_impl(const Crypter_T& crypter, value_type x,
-                            const tweak_t& tweak, uint64_t rounds) const override;
+                            const tweak_t& tweak, uint64_t rounds) const;
 
     value_type decrypt_impl(const Crypter_T& crypter, value_type x,
-                            const tweak_t& tweak, uint64_t rounds) const override;
+                            const tweak_t& tweak, uint64_t rounds) const;
 };
 
 
-template <typename Crypter_T, typename PRNG_T>
-auto CycleSlicer<Crypter_T, PRNG_T>::encrypt_impl(
+template <typename Crypter_T, typename PRNG_T, typename Incl_F>
+auto CycleSlicer<Crypter_T, PRNG_T, Incl_F>::encrypt_impl(
         const Crypter_T& crypter, value_type x, const tweak_t& tweak, uint64_t rounds)
 const -> value_type {
     for (uint64_t round = 0; round < rounds; ++round) {
@@ -114,8 +129,8 @@ const -> value_type {
     return x;
 }
 
-template <typename Crypter_T, typename PRNG_T>
-auto CycleSlicer<Crypter_T, PRNG_T>::decrypt_impl(
+template <typename Crypter_T, typename PRNG_T, typename Incl_F>
+auto CycleSlicer<Crypter_T, PRNG_T, Incl_F>::decrypt_impl(
         const Crypter_T& crypter, value_type x, const tweak_t& tweak, uint64_t rounds)
 const -> value_type {
     for (auto round = rounds; round > 0; --round) {
@@ -124,8 +139,8 @@ const -> value_type {
     return x;
 }
 
-template <typename Crypter_T, typename PRNG_T>
-auto CycleSlicer<Crypter_T, PRNG_T>::one_round(
+template <typename Crypter_T, typename PRNG_T, typename Incl_F>
+auto CycleSlicer<Crypter_T, PRNG_T, Incl_F>::one_round(
         const Crypter_T& crypter, const value_type& x, const tweak_t& tweak, uint64_t round_num)
 const -> value_type {
     tweak_t tweak_{*tweak.data() + round_num};
@@ -143,11 +158,27 @@ const -> value_type {
     return x;
 }
 
-template<typename Crypter_T, typename PRNG_T>
-auto CycleSlicer<Crypter_T, PRNG_T>::create_ptr(
+template<typename Crypter_T, typename PRNG_T, typename Incl_F>
+auto CycleSlicer<Crypter_T, PRNG_T, Incl_F>::create_ptr(
         CS_Seed seed, CycleSlicer::incl_fn_type incl_fn, uint64_t rounds)
 -> std::shared_ptr<Self>{
     return std::make_shared<Self>(std::move(seed), std::move(incl_fn), rounds);
 }
 
+template<typename Crypter_T, typename PRNG_T, typename Incl_F>
+auto CycleSlicer<Crypter_T, PRNG_T, Incl_F>::from_tv_threshold(
+        CS_Seed seed, CycleSlicer::incl_fn_type incl_fn,
+        uint64_t s_size, uint64_t t_size, double threshold)
+-> Self {
+    return Self{std::move(seed), std::move(incl_fn), cycle_slicer_rounds(s_size, t_size, threshold)};
+}
+
+/**
+ * CycleSlicer keeping the exact type of the Inclusion Function.
+ */
+template<typename Crypter_T, typename PRNG_T = aes::openssl::AesCtr128PRNG, typename Incl_F>
+CycleSlicer<Crypter_T, PRNG_T, Incl_F> make_cycle_slicer(CS_Seed seed, Incl_F incl_fn, uint64_t rounds) {
+    return CycleSlicer<Crypter_T, PRNG_T, Incl_F>{std::move(seed), std::move(incl_fn), rounds};
+}
+
 }  // namespace grafpe::domain::targeting
@@ -4,24 +4,37 @@
 
 #pragma once
 
+#include <algorithm>
 #include <functional>
 #include <utility>
+#include <vector>
 
 #include "grafpe/crypt/Grafpe.hpp"
+#include "grafpe/crypt/batch.hpp"
 
 namespace grafpe::domain::targeting {
 
-template <typename Crypter_T>
+/**
+ * Walks the cycle of the crypter until a value accepted by the predicate is reached.
+ *
+ * The predicate is a std::function by default, so that any callable can be used
+ * at runtime; giving its type explicitly (e.g. a lambda's, see make_cycle_walker)
+ * lets the compiler inline it into the walk.
+ */
+template <typename Crypter_T,
+          typename Predicate_T = std::function<bool(const typename Crypter_T::value_type&)>>
 class CycleWalker {
  public:
     using value_type = typename Crypter_T::value_type;
 
  private:
-    using predicate_t = std::function<bool(const value_type&)>;
+    using predicate_t = Predicate_T;
     predicate_t predicate;
-    using Self = CycleWalker<Crypter_T>;
+    using Self = CycleWalker<Crypter_T, Predicate_T>;
 
  public:
+    static constexpr std::size_t DEFAULT_LANES = 256;
+
     explicit CycleWalker(predicate_t predicate)
         : predicate {std::move(predicate)} { }
 
@@ -39,12 +52,41 @@ class CycleWalker {
     [[nodiscard]]
     value_type decrypt(const Crypter_T& crypter, value_type x, const tweak_t& tweak) const;
 
+    /**
+     * Encrypts `count` values, equivalent to calling encrypt for each of them.
+     *
+     * The values need different numbers of steps, so instead of walking the whole
+     * batch until the slowest value finishes, a fixed pool of lanes is kept in flight:
+     * after every step the values accepted by the predicate are retired and their
+     * lanes are refilled from the input. The crypter is therefore always fed
+     * with full batches (see crypter::encrypt_batch).
+     * `in` and `out` may be the same buffer.
+     */
+    void encrypt_batch(const Crypter_T& crypter, const value_type* in, value_type* out, std::size_t count,
+                       const tweak_t& tweak = {}, std::size_t lanes = DEFAULT_LANES) const {
+        walk_batch<true>(crypter, in, out, count, tweak, lanes);
+    }
+
+    /**
+     * Decrypts `count` values, equivalent to calling decrypt for each of them.
+     * @see encrypt_batch
+     */
+    void decrypt_batch(const Crypter_T& crypter, const value_type* in, value_type* out, std::size_t count,
+                       const tweak_t& tweak = {}, std::size_t lanes = DEFAULT_LANES) const {
+        walk_batch<false>(crypter, in, out, count, tweak, lanes);
+    }
+
     static std::shared_ptr<Self> create_ptr(predicate_t&& predicate);
+
+ private:
+    template <bool forward>
+    void walk_batch(const Crypter_T& crypter, const value_type* in, value_type* out, std::size_t count,
+                    const tweak_t& tweak, std::size_t lanes) const;
 };
 
-template<typename Crypter_T>
+template<typename Crypter_T, typename Predicate_T>
 auto
-CycleWalker<Crypter_T>::encrypt(const Crypter_T &crypter, value_type x, const tweak_t& tweak)
+CycleWalker<Crypter_T, Predicate_T>::encrypt(const Crypter_T &crypter, value_type x, const tweak_t& tweak)
 const -> value_type {
     do {
         x = crypter.encrypt(x, tweak);
@@ -52,9 +94,9 @@ const -> value_type {
     return x;
 }
 
-template<typename Crypter_T>
+template<typename Crypter_T, typename Predicate_T>
 auto
-CycleWalker<Crypter_T>::decrypt(const Crypter_T &crypter, value_type x, const tweak_t& tweak)
+CycleWalker<Crypter_T, Predicate_T>::decrypt(const Crypter_T &crypter, value_type x, const tweak_t& tweak)
 const -> value_type {
     do {
         x = crypter.decrypt(x, tweak);
@@ -62,9 +104,61 @@ const -> value_type {
     return x;
 }
 
-template<typename Crypter_T>
-auto CycleWalker<Crypter_T>::create_ptr(predicate_t&& predicate) -> std::shared_ptr<Self> {
+template<typename Crypter_T, typename Predicate_T>
+template<bool forward>
+void CycleWalker<Crypter_T, Predicate_T>::walk_batch(const Crypter_T &crypter, const value_type* in, value_type* out,
+                                                     std::size_t count, const tweak_t& tweak, std::size_t lanes) const {
+    if (count == 0) { return; }
+    lanes = std::max<std::size_t>(1, std::min(lanes, count));
+
+    // lane i holds the value of in[owner[i]]; only the first `active` lanes are in flight
+    std::vector<value_type> values(in, in + lanes);
+    std::vector<std::size_t> owner(lanes);
+    for (std::size_t i = 0; i < lanes; ++i) {
+        owner[i] = i;
+    }
+    std::size_t next = lanes;
+    std::size_t active = lanes;
+
+    while (active > 0) {
+        if constexpr (forward) {
+            crypter::encrypt_batch(crypter, values.data(), values.data(), active, tweak);
+        } else {
+            crypter::decrypt_batch(crypter, values.data(), values.data(), active, tweak);
+        }
+
+        for (std::size_t i = 0; i < active;) {
+            if (!predicate(values[i])) {
+                ++i;
+                continue;
+            }
+            // in[next] is read after out[owner[i]] is written, but owner[i] < next, so in == out is fine
+            out[owner[i]] = values[i];
+            if (next < count) {
+                values[i] = in[next];
+                owner[i] = next++;
+                ++i;
+            } else {
+                // the last lane has already made its step, so it is checked in place of the retired one
+                --active;
+                values[i] = values[active];
+                owner[i] = owner[active];
+            }
+        }
+    }
+}
+
+template<typename Crypter_T, typename Predicate_T>
+auto CycleWalker<Crypter_T, Predicate_T>::create_ptr(predicate_t&& predicate) -> std::shared_ptr<Self> {
     return std::make_shared<Self>(std::move(predicate));
 }
 
+/**
+ * CycleWalker keeping the exact type of the predicate.
+ */
+template<typename Crypter_T, typename Predicate_T>
+CycleWalker<Crypter_T, Predicate_T> make_cycle_walker(Predicate_T predicate) {
+    return CycleWalker<Crypter_T, Predicate_T>{std::move(predicate)};
+}
+
 }  // namespace grafpe::domain::targeting
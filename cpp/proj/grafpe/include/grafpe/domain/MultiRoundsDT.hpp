@@ -8,76 +8,82 @@
 
 namespace grafpe::domain::targeting {
 
-template <typename Crypter_T>
+/**
+ * Base of the targeters working in rounds, e.g. CycleSlicer.
+ *
+ * The derived targeter provides (possibly private, then MultiRoundsDT has to be its friend)
+ * non-virtual encrypt_impl and decrypt_impl taking the number of rounds, which are
+ * called directly, so that the rounds can be inlined together with a static crypter
+ * (see crypter::StaticTargeted).
+ *
+ * @tparam Derived_T - the targeter deriving from MultiRoundsDT
+ */
+template <typename Derived_T, typename Crypter_T>
 class MultiRoundsDT {
     using value_type = typename Crypter_T::value_type;
 
  public:
     [[nodiscard]]
     value_type encrypt(const Crypter_T& crypter, const value_type& x) const {
-        return encrypt_impl(crypter, x, {}, default_rounds_cnt);
+        return derived().encrypt_impl(crypter, x, {}, default_rounds_cnt);
     }
 
     [[nodiscard]]
     value_type decrypt(const Crypter_T& crypter, const value_type& x) const {
-        return decrypt_impl(crypter, x, {}, default_rounds_cnt);
+        return derived().decrypt_impl(crypter, x, {}, default_rounds_cnt);
     }
 
     [[nodiscard]]
     value_type encrypt(const Crypter_T& crypter, const value_type& x, uint64_t rounds) const {
-        return encrypt_impl(crypter, x, {}, rounds);
+        return derived().encrypt_impl(crypter, x, {}, rounds);
     }
 
     [[nodiscard]]
     value_type decrypt(const Crypter_T& crypter, const value_type& x, uint64_t rounds) const {
-        return decrypt_impl(crypter, x, {}, rounds);
+        return derived().decrypt_impl(crypter, x, {}, rounds);
     }
 
     [[nodiscard]]
     value_type encrypt(const Crypter_T& crypter, const value_type& x, const tweak_t& tweak) const {
-        return encrypt_impl(crypter, x, tweak, default_rounds_cnt);
+        return derived().encrypt_impl(crypter, x, tweak, default_rounds_cnt);
     }
 
     [[nodiscard]]
     value_type decrypt(const Crypter_T& crypter, const value_type& x, const tweak_t& tweak) const {
-        return decrypt_impl(crypter, x, tweak, default_rounds_cnt);
+        return derived().decrypt_impl(crypter, x, tweak, default_rounds_cnt);
     }
 
     [[nodiscard]]
     value_type encrypt(const Crypter_T& crypter, const value_type& x,
             const tweak_t& tweak, uint64_t round) const {
-        return encrypt_impl(crypter, x, tweak, round);
+        return derived().encrypt_impl(crypter, x, tweak, round);
     }
 
     [[nodiscard]]
     value_type decrypt(const Crypter_T& crypter, const value_type& x,
             const tweak_t& tweak, uint64_t round) const {
-        return decrypt_impl(crypter, x, tweak, round);
+        return derived().decrypt_impl(crypter, x, tweak, round);
     }
 
-    virtual MultiRoundsDT<Crypter_T>& set_rounds_cnt(uint64_t rounds) {
+    Derived_T& set_rounds_cnt(uint64_t rounds) {
         default_rounds_cnt = rounds;
-        return *this;
+        return static_cast<Derived_T&>(*this);
     }
 
     [[nodiscard]]
-    virtual uint64_t get_rounds_cnt() const {
+    uint64_t get_rounds_cnt() const {
         return default_rounds_cnt;
     }
 
-    ~MultiRoundsDT() = default;
-
  protected:
     MultiRoundsDT() = default;
+    ~MultiRoundsDT() = default;
     explicit MultiRoundsDT(uint64_t rounds_cnt): default_rounds_cnt { rounds_cnt } {   }
 
     uint64_t default_rounds_cnt {0};
 
-    virtual value_type encrypt_impl(const Crypter_T& crypter, value_type x,
-            const tweak_t& tweak, uint64_t round) const = 0;
-
-    virtual value_type decrypt_impl(const Crypter_T& crypter, value_type x,
-            const tweak_t& tweak, uint64_t round) const = 0;
+ private:
+    const Derived_T& derived() const noexcept { return static_cast<const Derived_T&>(*this); }
 };
 
 }  // namespace grafpe::domain::targeting
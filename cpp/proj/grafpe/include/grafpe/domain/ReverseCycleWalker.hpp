@@ -8,6 +8,7 @@
 #include <grafpe/domain/utils.hpp>
 #include <grafpe/crypt/Grafpe.hpp>
 #include "MultiRoundsDT.hpp"
+#include "rounds.hpp"
 
 #include <grafpe/config.hpp>
 
@@ -19,8 +20,9 @@ namespace grafpe::domain::targeting {
  */
 template<typename Crypter_T,
          typename PRNG_T = aes::openssl::AesCtr128PRNG>
-class ReverseCycleWalker: public MultiRoundsDT<Crypter_T> {
+class ReverseCycleWalker: public MultiRoundsDT<ReverseCycleWalker<Crypter_T, PRNG_T>, Crypter_T> {
     using Self = ReverseCycleWalker<Crypter_T, PRNG_T>;
+    friend MultiRoundsDT<Self, Crypter_T>;
 
  public:
     using  value_type = typename Crypter_T::value_type;
@@ -38,7 +40,7 @@ class ReverseCycleWalker: public MultiRoundsDT<Crypter_T> {
       }
 
     ReverseCycleWalker(vec_u8_t swap_seed, dom_fn_type domain_fn, uint64_t rounds)
-    : MultiRoundsDT<Crypter_T>(rounds),
+    : MultiRoundsDT<Self, Crypter_T>(rounds),
       swap_fn_seed {std::move(swap_seed)}, in_domain {std::move(domain_fn)} {
 #ifndef EXTENDED_RC_WALKER
         static_assert(std::is_integral_v<value_type>, "RCW supports only number-based FPE");
@@ -47,6 +49,14 @@ class ReverseCycleWalker: public MultiRoundsDT<Crypter_T> {
 
     static std::shared_ptr<Self> create_ptr(vec_u8_t swap_seed, dom_fn_type domain_fn, uint64_t rounds);
 
+    /**
+     * Creates a ReverseCycleWalker with the minimal default number of rounds
+     * that keeps the total variation distance below the threshold.
+     * The sizes are described in reverse_cycle_walker_rounds.
+     */
+    static Self from_tv_threshold(vec_u8_t swap_seed, dom_fn_type domain_fn,
+                                  uint64_t s_size, uint64_t t_size, double threshold);
+
  private:
     vec_u8_t swap_fn_seed;
     dom_fn_type in_domain;
@@ -55,10 +65,10 @@ class ReverseCycleWalker: public MultiRoundsDT<Crypter_T> {
             const tweak_t& tweak, uint64_t round_num) const;
 
     value_type encrypt_impl(const Crypter_T& crypter, value_type x,
-                            const tweak_t& tweak, uint64_t rounds) const override;
+                            const tweak_t& tweak, uint64_t rounds) const;
 
     value_type decrypt_impl(const Crypter_T& crypter, value_type x,
-                            const tweak_t& tweak, uint64_t rounds) const override;
+                            const tweak_t& tweak, uint64_t rounds) const;
 };
 
 
@@ -71,7 +81,8 @@ const -> value_type {
     value_type z = crypter.decrypt(x, tweak_);
 
 #ifdef EXTENDED_RC_WALKER
-    auto swap_fn = detail::create_boolPRF<PRNG_T, value_type>(swap_fn_seed, tweak_);
+    // the PRF lives for a single round and is queried at most once
+    auto swap_fn = detail::create_boolPRF<PRNG_T, value_type>(swap_fn_seed, tweak_, 1);
 #else
     auto swap_fn = detail::create_boolPRF<PRNG_T>(swap_fn_seed, tweak_, crypter.size());
 #endif
@@ -114,4 +125,14 @@ ReverseCycleWalker<Crypter_T, PRNG_T>::create_ptr(
 -> std::shared_ptr<Self> {
     return std::make_shared<Self>(std::move(swap_seed), std::move(domain_fn), rounds);
 }
+
+template<typename Crypter_T, typename PRNG_T>
+auto
+ReverseCycleWalker<Crypter_T, PRNG_T>::from_tv_threshold(
+        vec_u8_t swap_seed, ReverseCycleWalker::dom_fn_type domain_fn,
+        uint64_t s_size, uint64_t t_size, double threshold)
+-> Self {
+    return Self{std::move(swap_seed), std::move(domain_fn),
+                reverse_cycle_walker_rounds(s_size, t_size, threshold)};
+}
 }  // namespace grafpe::domain::targeting
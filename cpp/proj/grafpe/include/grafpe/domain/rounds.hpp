@@ -0,0 +1,50 @@
+/*
+ * author: Adam Budziak
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace grafpe::domain {
+
+/**
+ * Computes the minimal number of CycleSlicer rounds, for which the total variation
+ * distance from a random permutation drops below the given threshold.
+ *
+ * It's a port of tools/cslicer_rounds.py, the sizes are named as in the script.
+ *
+ * @param s_size - |S|
+ * @param t_size - |T|
+ * @param threshold - required total variation distance, must lie in (0, 1)
+ * @return the number of rounds
+ */
+uint64_t cycle_slicer_rounds(uint64_t s_size, uint64_t t_size, double threshold);
+
+/**
+ * Upper bound of the total variation distance after the given number
+ * of CycleSlicer rounds.
+ */
+double cycle_slicer_distance(uint64_t s_size, uint64_t t_size, uint64_t rounds);
+
+/**
+ * Computes the minimal number of ReverseCycleWalker rounds, for which the total variation
+ * distance from a random permutation drops below the given threshold.
+ *
+ * It's a port of tools/rcwalker_rounds.py, the sizes are named as in the script,
+ * |T| has to be greater than |S|.
+ *
+ * @param s_size - |S|
+ * @param t_size - |T|
+ * @param threshold - required total variation distance, must lie in (0, 1)
+ * @return the number of rounds
+ */
+uint64_t reverse_cycle_walker_rounds(uint64_t s_size, uint64_t t_size, double threshold);
+
+/**
+ * Upper bound of the total variation distance after the given number
+ * of ReverseCycleWalker rounds.
+ */
+double reverse_cycle_walker_distance(uint64_t s_size, uint64_t t_size, uint64_t rounds);
+
+}  // namespace grafpe::domain
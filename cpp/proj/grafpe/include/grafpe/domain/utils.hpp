@@ -23,13 +23,14 @@ auto create_boolPRF(const vec_u8_t& seed, const tweak_t& tweak, uint64_t range)
 }
 
 template <typename PRNG_T, typename value_type>
-auto create_boolPRF(const vec_u8_t& seed, const tweak_t& tweak)
+auto create_boolPRF(const vec_u8_t& seed, const tweak_t& tweak,
+                    std::size_t cache_capacity = LazyBoolPRF<PRNG_T, value_type>::DEFAULT_CACHE_CAPACITY)
 -> LazyBoolPRF<PRNG_T, value_type> {
     typename PRNG_T::key_type key {};
     typename PRNG_T::iv_type   iv {};
 
     generate_key_iv<typename PRNG_T::ctx_type>(seed, tweak, key, iv);
-    return LazyBoolPRF<PRNG_T, value_type>(key);
+    return LazyBoolPRF<PRNG_T, value_type>(key, cache_capacity);
 }
 
 }  // namespace grafpe::domain::detail
@@ -0,0 +1,86 @@
+/*
+ * author: Adam Budziak
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <grafpe/graph/Graph.hpp>
+
+namespace grafpe {
+
+/**
+ * Transition matrix of the walk performed by the crypters: every step applies
+ * one of the d/2 permutations of the graph or its inverse, each with
+ * probability 1/d (see GraphTraverser). The matrix is symmetric and doubly
+ * stochastic, so the uniform distribution is stationary.
+ *
+ * The matrix is never stored, applying it costs O(n * d) and is split among the threads.
+ */
+class TransitionMatrix {
+    uint64_t m_size;
+    perm_vec_t m_permutations;
+    perm_vec_t m_inverses;
+    std::size_t m_threads;
+
+ public:
+    /**
+     * @param threads - the number of threads used by apply, 0 means std::thread::hardware_concurrency
+     */
+    explicit TransitionMatrix(const Graph& graph, std::size_t threads = 0);
+
+    [[nodiscard]] uint64_t size() const noexcept { return m_size; }
+
+    /**
+     * out = P * in, i.e. the distribution after one more step; in and out can't overlap.
+     */
+    void apply(const std::vector<double>& in, std::vector<double>& out) const;
+
+ private:
+    void apply_rows(const double* in, double* out, uint64_t first, uint64_t last) const;
+};
+
+
+/**
+ * Total variation distance from the uniform distribution of the walk started
+ * in the start vertex, after 1, 2, ..., steps steps (the i-th element is after i + 1 steps).
+ *
+ * The distribution is propagated exactly in double precision, so distances
+ * below roughly n * 1e-16 are rounding noise; use the spectral bound for the smaller ones.
+ */
+std::vector<double> total_variation(const TransitionMatrix& matrix, point_t start, std::size_t steps);
+
+
+/**
+ * Upper bound of the second largest absolute eigenvalue of the transition matrix,
+ * max(lambda_2, -lambda_n), by the Lanczos iteration in the complement of the uniform vector.
+ *
+ * The extreme Ritz values never exceed the extreme eigenvalues and converge to them;
+ * the result adds their residuals, so it bounds the eigenvalues from above once
+ * the Ritz values are the closest to them. The iteration stops when both residuals
+ * drop below tolerance or after max_iterations, so a smaller tolerance gives a tighter bound.
+ */
+double second_eigenvalue(const TransitionMatrix& matrix, std::size_t max_iterations = 2000,
+                         double tolerance = 1e-6, uint64_t seed = 0);
+
+
+/**
+ * The smallest t for which the spectral bound 1/2 * sqrt(n) * lambda^t is at most target_tvd,
+ * i.e. the walk length making the walk from any vertex target_tvd-close to uniform.
+ * Throws std::domain_error if lambda isn't in [0, 1) (the walk doesn't mix).
+ */
+std::size_t spectral_walk_length(uint64_t n, double lambda, double target_tvd);
+
+
+/**
+ * The smallest t for which the walks started in all the start vertices are
+ * target_tvd-close to uniform after t steps, measured with total_variation.
+ * Returns 0 if that doesn't happen within max_steps.
+ */
+std::size_t min_walk_length(const TransitionMatrix& matrix, const std::vector<point_t>& starts,
+                            double target_tvd, std::size_t max_steps);
+
+}  // namespace grafpe
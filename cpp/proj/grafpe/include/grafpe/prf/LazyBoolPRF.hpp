@@ -6,7 +6,7 @@
 #include <grafpe/config.hpp>
 
 #include <utility>
-#include <unordered_map>
+#include <pur/containers/bit_cache.hpp>
 #include <grafpe/common/type_utils.hpp>
 #include <grafpe/crypt/utils.hpp>
 #ifdef HAS_BOOST
@@ -16,6 +16,12 @@
 namespace grafpe {
 
 /**
+ * A boolean PRF over an arbitrary domain, which computes the coins on demand.
+ *
+ * Every computed coin costs a key derivation and a PRNG construction,
+ * so the results are memoised in a fixed-capacity direct-mapped cache.
+ * The memory used is bounded by the capacity given during construction,
+ * and the cache statistics can be inspected with cache_stats.
  *
  * @tparam PRNG_T
  * @tparam value_type
@@ -30,10 +36,13 @@ class LazyBoolPRF {
 
  private:
     seed_type m_seed;
-    std::unordered_map<std::size_t, bool> m_data;
+    pur::bit_cache m_cache;
 
  public:
-    explicit LazyBoolPRF(const seed_type& seed) : m_seed {seed} {  }
+    static constexpr std::size_t DEFAULT_CACHE_CAPACITY = 1024;
+
+    explicit LazyBoolPRF(const seed_type& seed, std::size_t cache_capacity = DEFAULT_CACHE_CAPACITY)
+      : m_seed {seed}, m_cache {cache_capacity} {  }
 
     bool operator()(const value_type& value) {
         std::size_t hash;
@@ -46,14 +55,23 @@ class LazyBoolPRF {
             hash = std::hash<value_type>{}(value);
 #endif
         }
-        if (auto coin = m_data.find(hash); coin != m_data.end()) {
-            return coin->second;
+        if (auto coin = m_cache.find(hash); coin.has_value()) {
+            return coin.value();
         }
         key_type key {};
         iv_type   iv {};
         generate_key_iv<typename PRNG_T::ctx_type>(m_seed, tweak_t{hash}, key, iv);
-        m_data[hash] = PRNG_T{key, iv}.fetch_bit();
-        return m_data.at(hash);
+        bool coin = PRNG_T{key, iv}.fetch_bit();
+        m_cache.insert(hash, coin);
+        return coin;
+    }
+
+    [[nodiscard]] const pur::cache_statistics& cache_stats() const noexcept {
+        return m_cache.stats();
+    }
+
+    [[nodiscard]] std::size_t cache_capacity() const noexcept {
+        return m_cache.capacity();
     }
 };
 
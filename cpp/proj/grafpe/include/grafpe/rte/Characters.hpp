@@ -0,0 +1,52 @@
+/*
+ * author: Adam Budziak
+ */
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include <dfare/common/AlphabetCodec.hpp>
+#include <grafpe/common/type_utils.hpp>
+#include "../crypt/Cast.hpp"
+
+namespace grafpe::rte {
+
+/**
+ * Crypter of strings of any length over an alphabet, cast character by character.
+ *
+ * The characters are translated to their ranks in the alphabet (and back)
+ * with an AlphabetCodec, so casting costs a table read per character instead
+ * of ranking every character as a one-letter word of a RankedDFA.
+ * The wrapped crypter encrypts vectors of ranks, e.g. Grafpe over the size of the alphabet.
+ */
+template <typename Crypter_T>
+class Characters : public crypter::StringCastCrypter<Crypter_T> {
+    dfare::AlphabetCodec codec;
+
+ public:
+    using value_type = std::string;
+    using index_type = typename Crypter_T::value_type;
+
+    Characters(const dfare::Alphabet& alphabet, Crypter_T crypter):
+        crypter::StringCastCrypter<Crypter_T>{std::move(crypter)}, codec{alphabet} {  }
+
+    [[nodiscard]] const dfare::AlphabetCodec& alphabet_codec() const noexcept { return codec; }
+
+ protected:
+    index_type cast_impl(std::string_view value) const override {
+        index_type ranks(value.size());
+        codec.encode(value, ranks.data());
+        return ranks;
+    }
+
+    void uncast_impl(const index_type& value, std::string& out) const override {
+        const auto size = out.size();
+        out.resize(size + value.size());
+        codec.decode(value.data(), value.size(), out.data() + size);
+    }
+};
+
+}  // namespace grafpe::rte
@@ -4,29 +4,50 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
 #include <utility>
+#include <vector>
+
 #include <grafpe/common/type_utils.hpp>
 #include <grafpe/crypt/Cast.hpp>
-#include <algorithm>
 
 namespace grafpe::rte {
 
 /**
  * A crypter class used for encryption of homogeneous collections of items.
  *
+ * The items are indexed at construction with a flat open-addressing hash table
+ * (linear probing, at most half full), so casting an item to its index costs O(1).
+ * If an item occurs more than once, its first index is used.
+ * Casting an item that isn't in the container throws std::out_of_range.
  */
 template<typename Cont, typename Crypter_T>
 class Container: public crypter::CastCrypter<Crypter_T, typename Cont::value_type> {
     using Self = Container<Cont, Crypter_T>;
+
+    struct slot_t {
+        std::size_t hash;
+        std::size_t index;
+    };
+    static constexpr std::size_t EMPTY = std::numeric_limits<std::size_t>::max();
+
     Cont cont;
+    std::vector<slot_t> slots;
+    unsigned slots_bits = 0;
 
  public:
     using value_type = typename Cont::value_type;
     using index_type = typename Crypter_T::value_type;
 
-    Container(Cont cont, Crypter_T crypter) noexcept
+    Container(Cont cont, Crypter_T crypter)
       : crypter::CastCrypter<Crypter_T, typename Cont::value_type>{std::move(crypter)}, cont{ std::move(cont) } {
         static_assert(std::is_integral_v<index_type>);
+        build_index();
     }
 
     const Cont& container() const noexcept {
@@ -34,17 +55,39 @@ class Container: public crypter::CastCrypter<Crypter_T, typename Cont::value_typ
     }
 
     /**
-     * Searches for the given value in the container.
-     *
+     * Searches for the given value in the container, returns the end iterator if it's absent.
      */
     [[nodiscard]]
-    constexpr decltype(auto) find(const value_type& value) const {
-        return std::find(cont.begin(), cont.end(), value);
+    decltype(auto) find(const value_type& value) const {
+        auto index = index_of(value);
+        return index == EMPTY ? cont.end() : std::next(cont.begin(), index);
+    }
+
+    [[nodiscard]]
+    bool contains(const value_type& value) const {
+        return index_of(value) != EMPTY;
     }
 
  private:
-    constexpr inline index_type get_index(const value_type& value) const {
-        return static_cast<index_type>(find(value) - cont.begin());
+    static std::size_t hash_of(const value_type& value) {
+        return std::hash<value_type>{}(value);
+    }
+
+    // Fibonacci hashing spreads the weak hashes (e.g. identity for integers) over the table
+    std::size_t home_of(std::size_t hash) const noexcept {
+        return static_cast<std::size_t>((static_cast<uint64_t>(hash) * 0x9E3779B97F4A7C15ull) >> (64u - slots_bits));
+    }
+
+    void build_index();
+
+    std::size_t index_of(const value_type& value) const;
+
+    index_type get_index(const value_type& value) const {
+        auto index = index_of(value);
+        if (index == EMPTY) {
+            throw std::out_of_range("rte::Container: value not in the container");
+        }
+        return static_cast<index_type>(index);
     }
 
 protected:
@@ -57,4 +100,41 @@ protected:
     }
 };
 
+
+template<typename Cont, typename Crypter_T>
+void Container<Cont, Crypter_T>::build_index() {
+    const auto size = static_cast<std::size_t>(std::distance(cont.begin(), cont.end()));
+    slots_bits = 1;
+    while ((std::size_t{1} << slots_bits) < 2 * size) {
+        ++slots_bits;
+    }
+    slots.assign(std::size_t{1} << slots_bits, slot_t{0, EMPTY});
+    const auto mask = slots.size() - 1;
+
+    std::size_t index = 0;
+    for (auto it = cont.begin(); it != cont.end(); ++it, ++index) {
+        const auto hash = hash_of(*it);
+        auto pos = home_of(hash);
+        for (; slots[pos].index != EMPTY; pos = (pos + 1) & mask) {
+            if (slots[pos].hash == hash && *std::next(cont.begin(), slots[pos].index) == *it) { break; }
+        }
+        if (slots[pos].index == EMPTY) {
+            slots[pos] = {hash, index};
+        }
+    }
+}
+
+
+template<typename Cont, typename Crypter_T>
+std::size_t Container<Cont, Crypter_T>::index_of(const value_type& value) const {
+    const auto hash = hash_of(value);
+    const auto mask = slots.size() - 1;
+    for (auto pos = home_of(hash); slots[pos].index != EMPTY; pos = (pos + 1) & mask) {
+        if (slots[pos].hash == hash && *std::next(cont.begin(), slots[pos].index) == value) {
+            return slots[pos].index;
+        }
+    }
+    return EMPTY;
+}
+
 }  // namespace grafpe::rte
@@ -0,0 +1,175 @@
+/*
+ * author: Adam Budziak
+ */
+
+#pragma once
+
+#include <charconv>
+#include <cstdio>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <grafpe/common/type_utils.hpp>
+
+namespace grafpe::rte {
+
+/**
+ * Crypter of a single CSV field, reading a view of the field
+ * and appending the result to the output buffer.
+ */
+class Field {
+ public:
+    virtual ~Field() = default;
+
+    virtual void encrypt_into(std::string_view field, std::string& out, const tweak_t& tweak) const = 0;
+    virtual void decrypt_into(std::string_view field, std::string& out, const tweak_t& tweak) const = 0;
+};
+
+
+/**
+ * Field encrypted with any crypter of the library:
+ *  - crypters with encrypt_into (StringCastCrypter, e.g. rte::DFA, rte::Characters) work on the view directly,
+ *  - crypters of integers (e.g. ScalarGrafpe) get the field parsed as a decimal number;
+ *    if the crypter has size(), numbers outside of {0, ..., size() - 1} throw std::out_of_range
+ *    (ScalarGrafpe would reduce them modulo its size, so they couldn't be decrypted back),
+ *  - crypters of std::string (e.g. rte::Container) get a copy of the field.
+ */
+template <typename Crypter_T>
+class CrypterField final : public Field {
+    using value_type = typename Crypter_T::value_type;
+    Crypter_T m_crypter;
+
+    template <typename T, typename = void>
+    struct has_into : std::false_type {};
+
+    template <typename T>
+    struct has_into<T, std::void_t<decltype(std::declval<const T&>().encrypt_into(
+            std::string_view{}, std::declval<std::string&>(), std::declval<const tweak_t&>()))>> : std::true_type {};
+
+    template <typename T, typename = void>
+    struct has_size : std::false_type {};
+
+    template <typename T>
+    struct has_size<T, std::void_t<decltype(std::declval<const T&>().size())>> : std::true_type {};
+
+ public:
+    explicit CrypterField(Crypter_T crypter): m_crypter {std::move(crypter)} {
+        static_assert(has_into<Crypter_T>::value || std::is_integral_v<value_type>
+                      || std::is_same_v<value_type, std::string>,
+                      "CrypterField: the crypter has to work on strings or integers");
+    }
+
+    void encrypt_into(std::string_view field, std::string& out, const tweak_t& tweak) const override {
+        transform<true>(field, out, tweak);
+    }
+
+    void decrypt_into(std::string_view field, std::string& out, const tweak_t& tweak) const override {
+        transform<false>(field, out, tweak);
+    }
+
+ private:
+    template <bool forward>
+    void transform(std::string_view field, std::string& out, const tweak_t& tweak) const {
+        if constexpr (has_into<Crypter_T>::value) {
+            if constexpr (forward) {
+                m_crypter.encrypt_into(field, out, tweak);
+            } else {
+                m_crypter.decrypt_into(field, out, tweak);
+            }
+        } else if constexpr (std::is_integral_v<value_type>) {
+            value_type value {};
+            auto [end, error] = std::from_chars(field.data(), field.data() + field.size(), value);
+            if (error != std::errc{} || end != field.data() + field.size()) {
+                throw std::invalid_argument("CrypterField: not a number: " + std::string{field});
+            }
+            if constexpr (has_size<Crypter_T>::value) {
+                if (value >= m_crypter.size()) {
+                    throw std::out_of_range("CrypterField: number outside of the domain: " + std::string{field});
+                }
+            }
+            value = forward ? m_crypter.encrypt(value, tweak) : m_crypter.decrypt(value, tweak);
+
+            char digits[24];
+            auto result = std::to_chars(std::begin(digits), std::end(digits), value);
+            out.append(digits, result.ptr);
+        } else {
+            const auto value = std::string{field};
+            out += forward ? m_crypter.encrypt(value, tweak) : m_crypter.decrypt(value, tweak);
+        }
+    }
+};
+
+template <typename Crypter_T>
+std::shared_ptr<const Field> make_field(Crypter_T crypter) {
+    return std::make_shared<CrypterField<Crypter_T>>(std::move(crypter));
+}
+
+
+/**
+ * Streaming encryption of delimiter-separated records (CSV without quoting).
+ *
+ * The input is read in large chunks; the complete records of a chunk are split
+ * between the threads, and every thread transforms its records field by field
+ * (fields are views of the chunk) into its own output buffer. The buffers are
+ * written in order with single large writes, so the memory used is bounded
+ * by the size of a chunk (or the longest record, if it is longer), whatever the size of the input.
+ *
+ * The columns without a crypter (nullptr or past the end of `columns`) are copied as they are.
+ * Records end with '\n' (a preceding '\r' is kept); all the fields are encrypted under the same tweak.
+ */
+class CsvStream {
+ public:
+    using columns_type = std::vector<std::shared_ptr<const Field>>;
+
+    static constexpr std::size_t DEFAULT_CHUNK_SIZE = 8u << 20u;
+
+ private:
+    columns_type m_columns;
+    char m_delimiter;
+    std::size_t m_threads;
+    std::size_t m_chunk_size;
+
+ public:
+    /**
+     * @param threads - number of the transforming threads, 0 means std::thread::hardware_concurrency
+     */
+    explicit CsvStream(columns_type columns, char delimiter = ',', std::size_t threads = 0,
+                       std::size_t chunk_size = DEFAULT_CHUNK_SIZE);
+
+    /**
+     * Encrypts the records read from `in` until its end and writes them to `out`.
+     * If `header` is set, the first record is copied as it is.
+     * std::runtime_error is thrown on I/O errors; errors of the crypters are rethrown.
+     */
+    void encrypt(std::FILE* in, std::FILE* out, const tweak_t& tweak = {}, bool header = false) const {
+        run(in, out, tweak, header, true);
+    }
+
+    /**
+     * Decrypts the records read from `in` until its end and writes them to `out`.
+     * @see encrypt
+     */
+    void decrypt(std::FILE* in, std::FILE* out, const tweak_t& tweak = {}, bool header = false) const {
+        run(in, out, tweak, header, false);
+    }
+
+    /**
+     * Transforms complete records in memory, appending the result to `out`.
+     */
+    void transform(std::string_view records, std::string& out, const tweak_t& tweak, bool forward) const;
+
+ private:
+    void run(std::FILE* in, std::FILE* out, const tweak_t& tweak, bool header, bool forward) const;
+
+    void transform_parallel(std::string_view records, std::vector<std::string>& outputs,
+                            const tweak_t& tweak, bool forward) const;
+
+    void transform_record(std::string_view record, std::string& out, const tweak_t& tweak, bool forward) const;
+};
+
+}  // namespace grafpe::rte
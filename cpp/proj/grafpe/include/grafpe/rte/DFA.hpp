@@ -4,7 +4,9 @@
 
 #pragma once
 
+#include <stdexcept>
 #include <string>
+#include <string_view>
 #include <utility>
 
 #include <dfare/dfa/RankedDFA.hpp>
@@ -12,8 +14,14 @@
 
 namespace grafpe::rte {
 
+/**
+ * Crypter of the words of a fixed length accepted by a RankedDFA.
+ *
+ * Words are cast to their ranks straight from a std::string_view and unranked
+ * into the caller's buffer (see crypter::StringCastCrypter::encrypt_into).
+ */
 template <typename Crypter_T>
-class DFA : public crypter::CastCrypter<Crypter_T, std::string> {
+class DFA : public crypter::StringCastCrypter<Crypter_T> {
     using dfa_t = dfare::dfa::RankedDFA;
     dfa_t dfa;
 
@@ -22,23 +30,28 @@ class DFA : public crypter::CastCrypter<Crypter_T, std::string> {
     using index_type = typename Crypter_T::value_type;
 
     DFA(dfa_t dfa, Crypter_T crypter):
-        crypter::CastCrypter<Crypter_T, std::string>{std::move(crypter)}, dfa{std::move(dfa)} {
+        crypter::StringCastCrypter<Crypter_T>{std::move(crypter)}, dfa{std::move(dfa)} {
         static_assert(std::is_integral_v<index_type>);
     }
 
 protected:
-    index_type cast_impl(const value_type &value) const override;
-    value_type uncast_impl(const index_type &value) const override;
+    index_type cast_impl(std::string_view value) const override;
+    void uncast_impl(const index_type &value, std::string& out) const override;
 };
 
 template<typename Crypter_T>
-auto DFA<Crypter_T>::cast_impl(const std::string& value) const -> index_type {
+auto DFA<Crypter_T>::cast_impl(std::string_view value) const -> index_type {
+    if (value.size() != dfa.n || !dfa.accepts(value)) {
+        throw std::out_of_range("DFA: word outside of the language: " + std::string(value));
+    }
     return dfa.rank(value);
 }
 
 template<typename Crypter_T>
-std::string DFA<Crypter_T>::uncast_impl(const index_type& value) const {
-    return dfa.unrank(value);
+void DFA<Crypter_T>::uncast_impl(const index_type& value, std::string& out) const {
+    const auto size = out.size();
+    out.resize(size + dfa.n);
+    dfa.unrank(value, out.data() + size);
 }
 
 template<typename Crypter_T>
@@ -0,0 +1,87 @@
+/*
+ * author: Adam Budziak
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <grafpe/common/type_utils.hpp>
+#include <grafpe/service/protocol.hpp>
+
+namespace grafpe::service {
+
+/**
+ * Error reported by the daemon for a request.
+ */
+class service_error : public std::runtime_error {
+    status_t m_status;
+
+ public:
+    service_error(status_t status, const std::string& what)
+      : std::runtime_error {what}, m_status {status} {  }
+
+    [[nodiscard]] status_t status() const noexcept { return m_status; }
+};
+
+
+/**
+ * Blocking client of the encryption daemon (see Server).
+ *
+ * Batches longer than MAX_BATCH are split into several requests. A Client is
+ * a single connection, so it shouldn't be used by many threads at once.
+ * std::system_error is thrown on socket errors and service_error on the errors of the daemon.
+ */
+class Client {
+    int m_fd = -1;
+    uint32_t m_next_id = 0;
+
+ public:
+    explicit Client(const std::string& socket_path);
+    ~Client();
+
+    Client(const Client&) = delete;
+    Client& operator=(const Client&) = delete;
+
+    void encrypt(uint32_t crypter, const uint64_t* in, uint64_t* out, std::size_t count, const tweak_t& tweak = {}) {
+        call(op_t::encrypt, crypter, in, out, count, tweak);
+    }
+
+    void decrypt(uint32_t crypter, const uint64_t* in, uint64_t* out, std::size_t count, const tweak_t& tweak = {}) {
+        call(op_t::decrypt, crypter, in, out, count, tweak);
+    }
+
+    std::vector<uint64_t> encrypt(uint32_t crypter, const std::vector<uint64_t>& values, const tweak_t& tweak = {}) {
+        std::vector<uint64_t> result(values.size());
+        encrypt(crypter, values.data(), result.data(), values.size(), tweak);
+        return result;
+    }
+
+    std::vector<uint64_t> decrypt(uint32_t crypter, const std::vector<uint64_t>& values, const tweak_t& tweak = {}) {
+        std::vector<uint64_t> result(values.size());
+        decrypt(crypter, values.data(), result.data(), values.size(), tweak);
+        return result;
+    }
+
+    uint64_t encrypt(uint32_t crypter, uint64_t value, const tweak_t& tweak = {}) {
+        encrypt(crypter, &value, &value, 1, tweak);
+        return value;
+    }
+
+    uint64_t decrypt(uint32_t crypter, uint64_t value, const tweak_t& tweak = {}) {
+        decrypt(crypter, &value, &value, 1, tweak);
+        return value;
+    }
+
+ private:
+    void call(op_t op, uint32_t crypter, const uint64_t* in, uint64_t* out, std::size_t count, const tweak_t& tweak);
+
+    void send_all(const void* data, std::size_t size);
+    void receive_all(void* data, std::size_t size);
+};
+
+}  // namespace grafpe::service
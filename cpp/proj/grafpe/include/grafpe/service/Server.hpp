@@ -0,0 +1,155 @@
+/*
+ * author: Adam Budziak
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <grafpe/common/type_utils.hpp>
+#include <grafpe/crypt/batch.hpp>
+#include <grafpe/service/protocol.hpp>
+
+namespace grafpe::service {
+
+/**
+ * Crypter of uint64_t values served by the daemon, working on whole batches.
+ */
+class BatchCrypter {
+ public:
+    virtual ~BatchCrypter() = default;
+
+    virtual void encrypt_batch(const uint64_t* in, uint64_t* out, std::size_t count, const tweak_t& tweak) const = 0;
+    virtual void decrypt_batch(const uint64_t* in, uint64_t* out, std::size_t count, const tweak_t& tweak) const = 0;
+};
+
+/**
+ * BatchCrypter of any crypter of uint64_t values on {0, ..., size - 1}; the batch API of the crypter
+ * is used when it has one (see crypter::encrypt_batch).
+ *
+ * Batches with a value outside of the domain are rejected with std::out_of_range
+ * as a whole, since e.g. ScalarGrafpe would reduce them modulo its size.
+ */
+template <typename Crypter_T>
+class CrypterAdapter final : public BatchCrypter {
+    Crypter_T m_crypter;
+    uint64_t m_size;
+
+ public:
+    CrypterAdapter(Crypter_T crypter, uint64_t size): m_crypter {std::move(crypter)}, m_size {size} {
+        static_assert(std::is_same_v<typename Crypter_T::value_type, uint64_t>,
+                      "CrypterAdapter: the crypter has to work on uint64_t values");
+    }
+
+    void encrypt_batch(const uint64_t* in, uint64_t* out, std::size_t count, const tweak_t& tweak) const override {
+        check_domain(in, count);
+        crypter::encrypt_batch(m_crypter, in, out, count, tweak);
+    }
+
+    void decrypt_batch(const uint64_t* in, uint64_t* out, std::size_t count, const tweak_t& tweak) const override {
+        check_domain(in, count);
+        crypter::decrypt_batch(m_crypter, in, out, count, tweak);
+    }
+
+ private:
+    void check_domain(const uint64_t* values, std::size_t count) const {
+        if (std::any_of(values, values + count, [this](uint64_t value) { return value >= m_size; })) {
+            throw std::out_of_range("CrypterAdapter: value outside of the domain");
+        }
+    }
+};
+
+template <typename Crypter_T>
+std::shared_ptr<const BatchCrypter> make_batch_crypter(Crypter_T crypter, uint64_t size) {
+    return std::make_shared<CrypterAdapter<Crypter_T>>(std::move(crypter), size);
+}
+
+/**
+ * Adapter of a crypter knowing its domain, e.g. ScalarGrafpe, RadixGrafpe or Codebook.
+ */
+template <typename Crypter_T>
+std::shared_ptr<const BatchCrypter> make_batch_crypter(Crypter_T crypter) {
+    const auto size = static_cast<uint64_t>(crypter.size());
+    return make_batch_crypter(std::move(crypter), size);
+}
+
+/**
+ * Encryption daemon serving the crypters over a Unix domain socket (see protocol.hpp).
+ *
+ * The crypters are built once and stay in memory, so the clients don't pay
+ * for building the graphs. All the connections are served by a single epoll
+ * event loop with non-blocking sockets; the values of a request are encrypted
+ * as one batch. A connection isn't read while its unsent responses exceed
+ * MAX_PENDING_OUTPUT, so a client that doesn't read can't exhaust the memory.
+ *
+ * Linux only. std::system_error is thrown if the socket can't be set up.
+ */
+class Server {
+ public:
+    using crypters_type = std::vector<std::shared_ptr<const BatchCrypter>>;
+
+    static constexpr std::size_t MAX_PENDING_OUTPUT = 16u << 20u;
+
+ private:
+    struct connection_t {
+        std::vector<uint8_t> input;
+        std::vector<uint8_t> output;
+        std::size_t sent = 0;
+        uint32_t events = 0;
+        bool closing = false;
+    };
+
+    std::string m_path;
+    crypters_type m_crypters;
+    int m_listen_fd = -1;
+    int m_epoll_fd = -1;
+    int m_stop_fd = -1;
+    // of the bound socket file, removed only while it is still there
+    uint64_t m_device = 0;
+    uint64_t m_inode = 0;
+    std::unordered_map<int, connection_t> m_connections;
+    std::vector<uint64_t> m_values;
+
+ public:
+    /**
+     * Binds the socket, replacing a stale socket file at the path, i.e. one nobody listens on.
+     * std::system_error with EADDRINUSE is thrown if anything else is there;
+     * the i-th crypter is served under the id i.
+     */
+    Server(std::string socket_path, crypters_type crypters);
+    ~Server();
+
+    Server(const Server&) = delete;
+    Server& operator=(const Server&) = delete;
+
+    [[nodiscard]] const std::string& socket_path() const noexcept { return m_path; }
+
+    /**
+     * Serves the clients until stop is called.
+     */
+    void run();
+
+    /**
+     * Makes run return. Thread-safe and async-signal-safe.
+     */
+    void stop() noexcept;
+
+ private:
+    void accept_all();
+    void on_readable(int fd, connection_t& connection);
+    void flush(int fd, connection_t& connection);
+    void update_events(int fd, connection_t& connection);
+    void close_connection(int fd);
+
+    void handle(const request_header& request, const uint8_t* values, std::vector<uint8_t>& output);
+};
+
+}  // namespace grafpe::service
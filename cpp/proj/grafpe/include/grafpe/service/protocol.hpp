@@ -0,0 +1,57 @@
+/*
+ * author: Adam Budziak
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace grafpe::service {
+
+/*
+ * The binary protocol of the encryption daemon (see Server and Client).
+ *
+ * Every request is a request_header followed by `count` values (uint64_t),
+ * every response is a response_header followed by `count` values.
+ * Both ends run on the same machine, so all the fields are in the host byte order.
+ * Requests on one connection are answered in order; a client may pipeline them.
+ */
+
+enum class op_t : uint32_t {
+    encrypt = 1,
+    decrypt = 2
+};
+
+enum class status_t : uint32_t {
+    ok = 0,
+    unknown_crypter = 1,
+    unknown_op = 2,
+    // the crypter rejected a value (e.g. it was outside of its domain)
+    invalid_value = 3,
+    // the connection is closed after this one, since the rest of the stream can't be trusted
+    too_large = 4
+};
+
+struct request_header {
+    op_t op;
+    uint32_t crypter;
+    uint64_t tweak;
+    uint32_t count;
+    // echoed in the response
+    uint32_t id;
+};
+
+struct response_header {
+    status_t status;
+    uint32_t id;
+    uint32_t count;
+    uint32_t reserved;
+};
+
+static_assert(sizeof(request_header) == 24 && sizeof(response_header) == 16);
+
+// the limit of values in a single request (8 MiB of values)
+constexpr uint32_t MAX_BATCH = 1u << 20u;
+
+}  // namespace grafpe::service
@@ -44,4 +44,41 @@ cell_t GraphTraverser::go_back(cell_t start, const grafpe::vec_u8_t &B) const {
     return x;
 }
 
+
+GraphTraverser::Walk GraphTraverser::decode(const vec_u8_t &B) const {
+    Walk walk;
+    walk.forward.reserve(cryptCtx->walk_length);
+    walk.backward.reserve(cryptCtx->walk_length);
+
+    for (cell_t i = 0; i < cryptCtx->walk_length; ++i) {
+        auto[ti, dir] = get_permutation(B, cryptCtx->f-1, i);
+        walk.forward.push_back(dir ? cryptCtx->inv_permutations[ti].data()
+                                   : cryptCtx->permutations[ti].data());
+    }
+    for (cell_t i = cryptCtx->walk_length; i > 0; --i) {
+        auto[ti, dir] = get_permutation(B, cryptCtx->f-1, i - 1);
+        walk.backward.push_back(dir ? cryptCtx->permutations[ti].data()
+                                    : cryptCtx->inv_permutations[ti].data());
+    }
+    return walk;
+}
+
+
+cell_t GraphTraverser::go(cell_t start, const Walk &walk) const {
+    cell_t x = start;
+    for (auto step : walk.forward) {
+        x = step[x];
+    }
+    return x;
+}
+
+
+cell_t GraphTraverser::go_back(cell_t start, const Walk &walk) const {
+    cell_t x = start;
+    for (auto step : walk.backward) {
+        x = step[x];
+    }
+    return x;
+}
+
 }  // namespace grafpe
@@ -0,0 +1,157 @@
+/*
+ * author: Adam Budziak
+ */
+
+#include <grafpe/crypt/simd.hpp>
+
+#include <stdexcept>
+#include <string>
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#define GRAFPE_SIMD_X86
+#include <immintrin.h>
+#endif
+
+namespace grafpe::simd {
+
+namespace {
+
+void walk_scalar(const point_t* const* steps, std::size_t steps_cnt,
+                 point_t* values, std::size_t count) {
+    for (std::size_t i = 0; i < count; ++i) {
+        point_t x = values[i];
+        for (std::size_t s = 0; s < steps_cnt; ++s) {
+            x = steps[s][x];
+        }
+        values[i] = x;
+    }
+}
+
+#ifdef GRAFPE_SIMD_X86
+
+// Four independent gathers per step hide the latency of a single one.
+__attribute__((target("avx2")))
+void walk_avx2(const point_t* const* steps, std::size_t steps_cnt,
+               point_t* values, std::size_t count) {
+    constexpr std::size_t LANES = 16;
+
+    std::size_t i = 0;
+    for (; i + LANES <= count; i += LANES) {
+        auto ptr = reinterpret_cast<__m256i*>(values + i);
+        __m256i x0 = _mm256_loadu_si256(ptr);
+        __m256i x1 = _mm256_loadu_si256(ptr + 1);
+        __m256i x2 = _mm256_loadu_si256(ptr + 2);
+        __m256i x3 = _mm256_loadu_si256(ptr + 3);
+        for (std::size_t s = 0; s < steps_cnt; ++s) {
+            auto table = reinterpret_cast<const long long*>(steps[s]);
+            x0 = _mm256_i64gather_epi64(table, x0, 8);
+            x1 = _mm256_i64gather_epi64(table, x1, 8);
+            x2 = _mm256_i64gather_epi64(table, x2, 8);
+            x3 = _mm256_i64gather_epi64(table, x3, 8);
+        }
+        _mm256_storeu_si256(ptr, x0);
+        _mm256_storeu_si256(ptr + 1, x1);
+        _mm256_storeu_si256(ptr + 2, x2);
+        _mm256_storeu_si256(ptr + 3, x3);
+    }
+    walk_scalar(steps, steps_cnt, values + i, count - i);
+}
+
+__attribute__((target("avx512f")))
+void walk_avx512(const point_t* const* steps, std::size_t steps_cnt,
+                 point_t* values, std::size_t count) {
+    constexpr std::size_t LANES = 32;
+
+    // the unmasked gather leaves its source undefined, which -Wmaybe-uninitialized reports
+    const __m512i zero = _mm512_setzero_si512();
+    constexpr __mmask8 ALL = 0xFF;
+
+    std::size_t i = 0;
+    for (; i + LANES <= count; i += LANES) {
+        auto ptr = values + i;
+        __m512i x0 = _mm512_loadu_si512(ptr);
+        __m512i x1 = _mm512_loadu_si512(ptr + 8);
+        __m512i x2 = _mm512_loadu_si512(ptr + 16);
+        __m512i x3 = _mm512_loadu_si512(ptr + 24);
+        for (std::size_t s = 0; s < steps_cnt; ++s) {
+            auto table = steps[s];
+            x0 = _mm512_mask_i64gather_epi64(zero, ALL, x0, table, 8);
+            x1 = _mm512_mask_i64gather_epi64(zero, ALL, x1, table, 8);
+            x2 = _mm512_mask_i64gather_epi64(zero, ALL, x2, table, 8);
+            x3 = _mm512_mask_i64gather_epi64(zero, ALL, x3, table, 8);
+        }
+        _mm512_storeu_si512(ptr, x0);
+        _mm512_storeu_si512(ptr + 8, x1);
+        _mm512_storeu_si512(ptr + 16, x2);
+        _mm512_storeu_si512(ptr + 24, x3);
+    }
+    walk_avx2(steps, steps_cnt, values + i, count - i);
+}
+
+#endif
+
+isa detect() noexcept {
+#ifdef GRAFPE_SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) { return isa::avx512; }
+    if (__builtin_cpu_supports("avx2")) { return isa::avx2; }
+#endif
+    return isa::scalar;
+}
+
+}  // namespace
+
+
+const char* to_string(isa instruction_set) noexcept {
+    switch (instruction_set) {
+        case isa::avx2: return "avx2";
+        case isa::avx512: return "avx512";
+        default: return "scalar";
+    }
+}
+
+
+bool is_supported(isa instruction_set) noexcept {
+    return instruction_set <= best_supported();
+}
+
+
+isa best_supported() noexcept {
+    static const isa best = detect();
+    return best;
+}
+
+
+std::vector<isa> all_supported() {
+    std::vector<isa> result;
+    for (auto instruction_set : {isa::scalar, isa::avx2, isa::avx512}) {
+        if (is_supported(instruction_set)) {
+            result.push_back(instruction_set);
+        }
+    }
+    return result;
+}
+
+
+void walk(const point_t* const* steps, std::size_t steps_cnt,
+          point_t* values, std::size_t count, isa instruction_set) {
+    if (!is_supported(instruction_set)) {
+        throw std::invalid_argument(std::string{"simd::walk: "} + to_string(instruction_set)
+                                    + " is not supported by the CPU");
+    }
+
+    switch (instruction_set) {
+#ifdef GRAFPE_SIMD_X86
+        case isa::avx512:
+            walk_avx512(steps, steps_cnt, values, count);
+            break;
+        case isa::avx2:
+            walk_avx2(steps, steps_cnt, values, count);
+            break;
+#endif
+        default:
+            walk_scalar(steps, steps_cnt, values, count);
+    }
+}
+
+}  // namespace grafpe::simd
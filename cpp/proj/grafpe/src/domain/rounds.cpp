@@ -0,0 +1,86 @@
+/*
+ * author: Adam Budziak
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include <grafpe/domain/rounds.hpp>
+
+namespace grafpe::domain {
+
+namespace {
+
+void validate(uint64_t s_size, uint64_t t_size, double threshold) {
+    if (s_size < 2 || t_size == 0) {
+        throw std::invalid_argument("rounds: |S| has to be at least 2 and |T| positive");
+    }
+    if (!(threshold > 0 && threshold < 1)) {
+        throw std::invalid_argument("rounds: threshold has to lie in (0, 1)");
+    }
+}
+
+double cycle_slicer_T(double NS, double NT) {
+    const double max_lhs = 40 * std::log(2 * NS * NS);
+    const double max_rhs = (10 * std::log(NS / 9))
+            / std::log(1 + (7. / 144) * ((7. / 9) * NS * NS - NS) / (NT * NT));
+    const double offset = (144 * NT * std::log(2 * NS * NS)) / NS;
+
+    return std::max(max_lhs, max_rhs) + offset;
+}
+
+double reverse_cycle_walker_T(double NS, double NT) {
+    const double c = NT / NS;
+    const double max_lhs = 40 * std::log(2 * NS * NS);
+    const double max_rhs = (10 * std::log(NS / 9))
+            / std::log(1 + 0.3 * std::pow(c - 1, 4) / std::pow(c, 6));
+    const double offset = (36 * std::pow(c, 3) * std::log(2 * NS * NS)) / ((c - 1) * (c - 1));
+
+    return std::max(max_lhs, max_rhs) + offset;
+}
+
+double distance(double NS, double T, uint64_t rounds) {
+    return std::pow(NS, 1 - 2 * static_cast<double>(rounds) / T);
+}
+
+uint64_t rounds(double NS, double T, double threshold) {
+    auto r = static_cast<uint64_t>(T / 2 * (1 - std::log(threshold) / std::log(NS)));
+    if (distance(NS, T, r) > threshold) {
+        ++r;
+    }
+    return r;
+}
+
+}  // namespace
+
+
+uint64_t cycle_slicer_rounds(uint64_t s_size, uint64_t t_size, double threshold) {
+    validate(s_size, t_size, threshold);
+    const auto NS = static_cast<double>(s_size);
+    return rounds(NS, cycle_slicer_T(NS, static_cast<double>(t_size)), threshold);
+}
+
+
+double cycle_slicer_distance(uint64_t s_size, uint64_t t_size, uint64_t rounds) {
+    const auto NS = static_cast<double>(s_size);
+    return distance(NS, cycle_slicer_T(NS, static_cast<double>(t_size)), rounds);
+}
+
+
+uint64_t reverse_cycle_walker_rounds(uint64_t s_size, uint64_t t_size, double threshold) {
+    validate(s_size, t_size, threshold);
+    if (t_size <= s_size) {
+        throw std::invalid_argument("rounds: ReverseCycleWalker requires |T| > |S|");
+    }
+    const auto NS = static_cast<double>(s_size);
+    return rounds(NS, reverse_cycle_walker_T(NS, static_cast<double>(t_size)), threshold);
+}
+
+
+double reverse_cycle_walker_distance(uint64_t s_size, uint64_t t_size, uint64_t rounds) {
+    const auto NS = static_cast<double>(s_size);
+    return distance(NS, reverse_cycle_walker_T(NS, static_cast<double>(t_size)), rounds);
+}
+
+}  // namespace grafpe::domain
@@ -0,0 +1,306 @@
+/*
+ * author: Adam Budziak
+ */
+
+#include <grafpe/graph/mixing.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <thread>
+
+#include <grafpe/permutation/utils.hpp>
+
+namespace grafpe {
+
+namespace {
+
+constexpr uint64_t MIN_ROWS_PER_THREAD = 1u << 14u;
+
+double distance_from_uniform(const std::vector<double>& distribution) {
+    const auto uniform = 1.0 / static_cast<double>(distribution.size());
+    double distance = 0;
+    for (auto p : distribution) {
+        distance += std::abs(p - uniform);
+    }
+    return distance / 2;
+}
+
+/**
+ * Walks from the start vertex, calling on_step(t, tvd) after each step t
+ * until it returns false or after max_steps steps.
+ */
+template <typename OnStep_F>
+void propagate(const TransitionMatrix& matrix, point_t start, std::size_t max_steps, OnStep_F on_step) {
+    if (start >= matrix.size()) {
+        throw std::out_of_range("propagate: start vertex outside of the graph");
+    }
+    std::vector<double> current(matrix.size(), 0.0);
+    std::vector<double> next(matrix.size());
+    current[start] = 1.0;
+
+    for (std::size_t t = 1; t <= max_steps; ++t) {
+        matrix.apply(current, next);
+        current.swap(next);
+        if (!on_step(t, distance_from_uniform(current))) { return; }
+    }
+}
+
+void subtract_mean(std::vector<double>& v) {
+    double sum = 0;
+    for (auto x : v) { sum += x; }
+    const auto mean = sum / static_cast<double>(v.size());
+    for (auto& x : v) { x -= mean; }
+}
+
+double dot(const std::vector<double>& u, const std::vector<double>& v) {
+    double sum = 0;
+    for (std::size_t i = 0; i < u.size(); ++i) { sum += u[i] * v[i]; }
+    return sum;
+}
+
+double norm(const std::vector<double>& v) {
+    return std::sqrt(dot(v, v));
+}
+
+constexpr double ZERO_BETA = 1e-12;
+constexpr double TINY_PIVOT = 1e-300;
+
+/**
+ * Symmetric tridiagonal matrix, beta[i] is at (i, i + 1) and (i + 1, i).
+ */
+struct tridiagonal_t {
+    std::vector<double> alpha;
+    std::vector<double> beta;
+};
+
+// the number of eigenvalues smaller than x (signs of the Sturm sequence)
+std::size_t count_below(const tridiagonal_t& t, double x) {
+    std::size_t count = 0;
+    double pivot = 1;
+    for (std::size_t i = 0; i < t.alpha.size(); ++i) {
+        pivot = t.alpha[i] - x - (i > 0 ? t.beta[i - 1] * t.beta[i - 1] / pivot : 0.0);
+        if (pivot == 0) { pivot = -TINY_PIVOT; }
+        count += pivot < 0;
+    }
+    return count;
+}
+
+/**
+ * The largest (or the smallest) eigenvalue by bisection, rounded outwards.
+ */
+double extreme_eigenvalue(const tridiagonal_t& t, bool largest) {
+    const auto size = t.alpha.size();
+    // Gershgorin discs contain the whole spectrum
+    double low = t.alpha[0], high = t.alpha[0];
+    for (std::size_t i = 0; i < size; ++i) {
+        const auto radius = (i > 0 ? std::abs(t.beta[i - 1]) : 0.0) + (i + 1 < size ? std::abs(t.beta[i]) : 0.0);
+        low = std::min(low, t.alpha[i] - radius);
+        high = std::max(high, t.alpha[i] + radius);
+    }
+    for (;;) {
+        const auto middle = low + (high - low) / 2;
+        if (middle <= low || middle >= high) { break; }
+        const auto below = count_below(t, middle);
+        if (largest ? below == size : below > 0) {
+            high = middle;
+        } else {
+            low = middle;
+        }
+    }
+    return largest ? high : low;
+}
+
+/**
+ * The absolute value of the last coordinate of the unit eigenvector of the eigenvalue,
+ * by inverse iteration (tridiagonal elimination with partial pivoting).
+ */
+double last_coordinate(const tridiagonal_t& t, double eigenvalue) {
+    const auto size = t.alpha.size();
+    if (size == 1) { return 1; }
+
+    std::vector<double> x(size, 1.0);
+    for (int iteration = 0; iteration < 3; ++iteration) {
+        std::vector<double> d(size), upper(t.beta), upper2(size - 1, 0.0), lower(t.beta);
+        for (std::size_t i = 0; i < size; ++i) { d[i] = t.alpha[i] - eigenvalue; }
+
+        for (std::size_t i = 0; i + 1 < size; ++i) {
+            if (std::abs(d[i]) >= std::abs(lower[i])) {
+                if (d[i] == 0) { d[i] = TINY_PIVOT; }
+                const auto factor = lower[i] / d[i];
+                d[i + 1] -= factor * upper[i];
+                x[i + 1] -= factor * x[i];
+            } else {
+                // the rows i and i + 1 are swapped, which fills in the second superdiagonal
+                const auto factor = d[i] / lower[i];
+                d[i] = lower[i];
+                const auto next = d[i + 1];
+                d[i + 1] = upper[i] - factor * next;
+                if (i + 2 < size) {
+                    upper2[i] = upper[i + 1];
+                    upper[i + 1] = -factor * upper2[i];
+                }
+                upper[i] = next;
+                std::swap(x[i], x[i + 1]);
+                x[i + 1] -= factor * x[i];
+            }
+        }
+        for (std::size_t i = size; i-- > 0;) {
+            if (d[i] == 0) { d[i] = TINY_PIVOT; }
+            const auto rest = (i + 1 < size ? upper[i] * x[i + 1] : 0.0) + (i + 2 < size ? upper2[i] * x[i + 2] : 0.0);
+            x[i] = (x[i] - rest) / d[i];
+        }
+
+        const auto length = norm(x);
+        for (auto& value : x) { value /= length; }
+    }
+    return std::abs(x.back());
+}
+
+}  // namespace
+
+
+TransitionMatrix::TransitionMatrix(const Graph& graph, std::size_t threads)
+  : m_size {graph.n}, m_permutations {graph.permutations},
+    m_inverses {inverse_permutations(graph.permutations)},
+    m_threads {threads ? threads : std::max(1u, std::thread::hardware_concurrency())} {
+    if (m_size == 0 || m_permutations.empty()) {
+        throw std::invalid_argument("TransitionMatrix: the graph has no vertices or no edges");
+    }
+}
+
+
+void TransitionMatrix::apply_rows(const double* in, double* out, uint64_t first, uint64_t last) const {
+    const auto weight = 1.0 / static_cast<double>(2 * m_permutations.size());
+    // the step goes from x to pi(x) or pi^-1(x), so y is reached from pi^-1(y) and pi(y)
+    for (uint64_t y = first; y < last; ++y) {
+        double sum = 0;
+        for (std::size_t i = 0; i < m_permutations.size(); ++i) {
+            sum += in[m_inverses[i][y]] + in[m_permutations[i][y]];
+        }
+        out[y] = sum * weight;
+    }
+}
+
+
+void TransitionMatrix::apply(const std::vector<double>& in, std::vector<double>& out) const {
+    if (in.size() != m_size) {
+        throw std::invalid_argument("TransitionMatrix: the vector doesn't match the graph");
+    }
+    out.resize(m_size);
+
+    const auto threads_cnt = std::max<uint64_t>(1, std::min<uint64_t>(m_threads, m_size / MIN_ROWS_PER_THREAD));
+    std::vector<std::thread> workers;
+    for (uint64_t i = 1; i < threads_cnt; ++i) {
+        workers.emplace_back([&, i] {
+            apply_rows(in.data(), out.data(), i * m_size / threads_cnt, (i + 1) * m_size / threads_cnt);
+        });
+    }
+    apply_rows(in.data(), out.data(), 0, m_size / threads_cnt);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+
+std::vector<double> total_variation(const TransitionMatrix& matrix, point_t start, std::size_t steps) {
+    std::vector<double> distances;
+    distances.reserve(steps);
+    propagate(matrix, start, steps, [&](std::size_t, double distance) {
+        distances.push_back(distance);
+        return true;
+    });
+    return distances;
+}
+
+
+double second_eigenvalue(const TransitionMatrix& matrix, std::size_t max_iterations, double tolerance,
+                         uint64_t seed) {
+    if (matrix.size() < 2) {
+        return 0;
+    }
+
+    // the uniform vector is the eigenvector of 1, the rest of the spectrum lives in its complement
+    std::mt19937_64 engine {seed};
+    std::uniform_real_distribution<double> distribution {-1.0, 1.0};
+    std::vector<double> q(matrix.size());
+    for (auto& x : q) { x = distribution(engine); }
+    subtract_mean(q);
+    const auto length = norm(q);
+    for (auto& x : q) { x /= length; }
+
+    std::vector<double> previous(matrix.size(), 0.0);
+    std::vector<double> w(matrix.size());
+    tridiagonal_t lanczos;
+    double bound = 1;
+    for (std::size_t j = 0; j < max_iterations; ++j) {
+        matrix.apply(q, w);
+        // removes the uniform component brought back by the rounding errors
+        subtract_mean(w);
+        const auto alpha = dot(w, q);
+        const auto previous_beta = j > 0 ? lanczos.beta.back() : 0.0;
+        for (std::size_t x = 0; x < w.size(); ++x) {
+            w[x] -= alpha * q[x] + previous_beta * previous[x];
+        }
+        const auto beta = norm(w);
+        lanczos.alpha.push_back(alpha);
+
+        // the residual of a Ritz pair is beta times the last coordinate of its vector
+        const auto top = extreme_eigenvalue(lanczos, true);
+        const auto bottom = extreme_eigenvalue(lanczos, false);
+        const auto top_residual = beta * last_coordinate(lanczos, top);
+        const auto bottom_residual = beta * last_coordinate(lanczos, bottom);
+        bound = std::min(1.0, std::max(top + top_residual, bottom_residual - bottom));
+        // a zero beta means that the Krylov subspace is invariant and the Ritz values are exact
+        if (std::max(top_residual, bottom_residual) <= tolerance || beta <= ZERO_BETA) { break; }
+
+        lanczos.beta.push_back(beta);
+        previous.swap(q);
+        for (std::size_t x = 0; x < w.size(); ++x) {
+            q[x] = w[x] / beta;
+        }
+    }
+    return std::max(0.0, bound);
+}
+
+
+std::size_t spectral_walk_length(uint64_t n, double lambda, double target_tvd) {
+    if (!(lambda >= 0 && lambda < 1)) {
+        throw std::domain_error("spectral_walk_length: the walk doesn't mix");
+    }
+    if (!(target_tvd > 0)) {
+        throw std::domain_error("spectral_walk_length: the target distance has to be positive");
+    }
+    const auto initial = std::sqrt(static_cast<double>(n)) / 2;
+    if (initial <= target_tvd) {
+        return 0;
+    }
+    if (lambda == 0) {
+        return 1;
+    }
+    return static_cast<std::size_t>(std::ceil(std::log(target_tvd / initial) / std::log(lambda)));
+}
+
+
+std::size_t min_walk_length(const TransitionMatrix& matrix, const std::vector<point_t>& starts,
+                            double target_tvd, std::size_t max_steps) {
+    std::size_t result = 0;
+    for (auto start : starts) {
+        std::size_t length = 0;
+        propagate(matrix, start, max_steps, [&](std::size_t t, double distance) {
+            if (distance <= target_tvd) {
+                length = t;
+                return false;
+            }
+            return true;
+        });
+        if (length == 0) {
+            return 0;
+        }
+        result = std::max(result, length);
+    }
+    return result;
+}
+
+}  // namespace grafpe
@@ -0,0 +1,180 @@
+/*
+ * author: Adam Budziak
+ */
+
+#include <grafpe/rte/Csv.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <exception>
+#include <thread>
+
+namespace grafpe::rte {
+
+namespace {
+
+constexpr std::size_t MIN_BYTES_PER_THREAD = 64u << 10u;
+
+void write_all(std::FILE* out, std::string_view data) {
+    if (!data.empty() && std::fwrite(data.data(), 1, data.size(), out) != data.size()) {
+        throw std::runtime_error("CsvStream: write error");
+    }
+}
+
+}  // namespace
+
+
+CsvStream::CsvStream(columns_type columns, char delimiter, std::size_t threads, std::size_t chunk_size)
+  : m_columns {std::move(columns)}, m_delimiter {delimiter},
+    m_threads {threads ? threads : std::max(1u, std::thread::hardware_concurrency())},
+    m_chunk_size {std::max<std::size_t>(chunk_size, 1)} {
+    if (delimiter == '\n' || delimiter == '\r') {
+        throw std::invalid_argument("CsvStream: the delimiter can't be a line break");
+    }
+}
+
+
+void CsvStream::transform(std::string_view records, std::string& out, const tweak_t& tweak, bool forward) const {
+    std::size_t pos = 0;
+    while (pos < records.size()) {
+        const auto end = std::min(records.find('\n', pos), records.size());
+        auto record = records.substr(pos, end - pos);
+        const bool cr = !record.empty() && record.back() == '\r';
+        if (cr) {
+            record.remove_suffix(1);
+        }
+
+        // empty lines are kept as they are
+        if (!record.empty()) {
+            transform_record(record, out, tweak, forward);
+        }
+
+        if (cr) { out += '\r'; }
+        if (end < records.size()) { out += '\n'; }
+        pos = end + 1;
+    }
+}
+
+
+void CsvStream::transform_record(std::string_view record, std::string& out, const tweak_t& tweak,
+                                 bool forward) const {
+    std::size_t start = 0;
+    for (std::size_t column = 0;; ++column) {
+        const auto stop = record.find(m_delimiter, start);
+        const auto field = record.substr(start, stop == std::string_view::npos ? stop : stop - start);
+
+        if (column < m_columns.size() && m_columns[column]) {
+            if (forward) {
+                m_columns[column]->encrypt_into(field, out, tweak);
+            } else {
+                m_columns[column]->decrypt_into(field, out, tweak);
+            }
+        } else {
+            out += field;
+        }
+
+        if (stop == std::string_view::npos) { break; }
+        out += m_delimiter;
+        start = stop + 1;
+    }
+}
+
+
+void CsvStream::transform_parallel(std::string_view records, std::vector<std::string>& outputs,
+                                   const tweak_t& tweak, bool forward) const {
+    const auto threads_cnt = std::max<std::size_t>(1, std::min(m_threads, records.size() / MIN_BYTES_PER_THREAD));
+
+    // every slice ends right after a '\n' (or at the end of the records)
+    std::vector<std::string_view> slices;
+    std::size_t first = 0;
+    for (std::size_t i = 1; i < threads_cnt && first < records.size(); ++i) {
+        const auto target = std::max(first, i * records.size() / threads_cnt);
+        const auto end = records.find('\n', target);
+        if (end == std::string_view::npos) { break; }
+        slices.push_back(records.substr(first, end + 1 - first));
+        first = end + 1;
+    }
+    slices.push_back(records.substr(first));
+
+    if (outputs.size() < slices.size()) {
+        outputs.resize(slices.size());
+    }
+    for (auto& output : outputs) {
+        output.clear();
+    }
+
+    // the first error is rethrown once all the slices are done
+    std::vector<std::exception_ptr> errors(slices.size());
+    const auto work = [&](std::size_t i) {
+        try {
+            transform(slices[i], outputs[i], tweak, forward);
+        } catch (...) {
+            errors[i] = std::current_exception();
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (std::size_t i = 1; i < slices.size(); ++i) {
+        workers.emplace_back(work, i);
+    }
+    work(0);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    for (auto& error : errors) {
+        if (error) { std::rethrow_exception(error); }
+    }
+}
+
+
+void CsvStream::run(std::FILE* in, std::FILE* out, const tweak_t& tweak, bool header, bool forward) const {
+    std::string buffer(m_chunk_size, '\0');
+    std::size_t filled = 0;
+    std::vector<std::string> outputs(m_threads);
+    bool eof = false;
+
+    while (!eof || filled > 0) {
+        while (!eof && filled < buffer.size()) {
+            const auto read = std::fread(buffer.data() + filled, 1, buffer.size() - filled, in);
+            filled += read;
+            if (read == 0) {
+                if (std::ferror(in)) {
+                    throw std::runtime_error("CsvStream: read error");
+                }
+                eof = true;
+            }
+        }
+
+        const auto data = std::string_view{buffer.data(), filled};
+        // only the complete records are transformed, the rest waits for the next chunk
+        auto complete = eof ? filled : data.rfind('\n') + 1;
+        if (complete == 0) {
+            if (eof) { break; }
+            // a record longer than the buffer
+            buffer.resize(2 * buffer.size());
+            continue;
+        }
+
+        auto records = data.substr(0, complete);
+        if (header) {
+            const auto end = std::min(records.find('\n'), records.size() - 1) + 1;
+            write_all(out, records.substr(0, end));
+            records.remove_prefix(end);
+            header = false;
+        }
+
+        transform_parallel(records, outputs, tweak, forward);
+        for (const auto& output : outputs) {
+            write_all(out, output);
+        }
+
+        std::memmove(buffer.data(), buffer.data() + complete, filled - complete);
+        filled -= complete;
+    }
+
+    if (std::fflush(out) != 0) {
+        throw std::runtime_error("CsvStream: write error");
+    }
+}
+
+}  // namespace grafpe::rte
@@ -0,0 +1,117 @@
+/*
+ * author: Adam Budziak
+ */
+
+#include <grafpe/service/Client.hpp>
+
+#if defined(__linux__)
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <system_error>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace grafpe::service {
+
+namespace {
+
+[[noreturn]] void throw_errno(const char* what) {
+    throw std::system_error(errno, std::generic_category(), what);
+}
+
+const char* describe(status_t status) {
+    switch (status) {
+        case status_t::unknown_crypter: return "service: unknown crypter";
+        case status_t::unknown_op: return "service: unknown operation";
+        case status_t::invalid_value: return "service: value rejected by the crypter";
+        case status_t::too_large: return "service: request too large";
+        default: return "service: unknown error";
+    }
+}
+
+}  // namespace
+
+
+Client::Client(const std::string& socket_path) {
+    sockaddr_un address {};
+    address.sun_family = AF_UNIX;
+    if (socket_path.size() >= sizeof(address.sun_path)) {
+        throw std::invalid_argument("Client: socket path too long");
+    }
+    std::memcpy(address.sun_path, socket_path.c_str(), socket_path.size() + 1);
+
+    if ((m_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0)) < 0) {
+        throw_errno("Client: socket");
+    }
+    if (connect(m_fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+        const auto error = errno;
+        close(m_fd);
+        errno = error;
+        throw_errno("Client: connect");
+    }
+}
+
+
+Client::~Client() {
+    close(m_fd);
+}
+
+
+void Client::call(op_t op, uint32_t crypter, const uint64_t* in, uint64_t* out, std::size_t count,
+                  const tweak_t& tweak) {
+    for (std::size_t first = 0; first < count; first += MAX_BATCH) {
+        const auto n = static_cast<uint32_t>(std::min<std::size_t>(MAX_BATCH, count - first));
+        const request_header request {op, crypter, *tweak.data(), n, m_next_id++};
+        send_all(&request, sizeof(request));
+        send_all(in + first, n * sizeof(uint64_t));
+
+        response_header response;
+        receive_all(&response, sizeof(response));
+        if (response.status != status_t::ok) {
+            throw service_error(response.status, describe(response.status));
+        }
+        if (response.id != request.id || response.count != n) {
+            throw std::runtime_error("Client: malformed response");
+        }
+        receive_all(out + first, n * sizeof(uint64_t));
+    }
+}
+
+
+void Client::send_all(const void* data, std::size_t size) {
+    auto bytes = static_cast<const uint8_t*>(data);
+    while (size > 0) {
+        const auto sent = send(m_fd, bytes, size, MSG_NOSIGNAL);
+        if (sent < 0) {
+            if (errno == EINTR) { continue; }
+            throw_errno("Client: send");
+        }
+        bytes += sent;
+        size -= static_cast<std::size_t>(sent);
+    }
+}
+
+
+void Client::receive_all(void* data, std::size_t size) {
+    auto bytes = static_cast<uint8_t*>(data);
+    while (size > 0) {
+        const auto received = recv(m_fd, bytes, size, 0);
+        if (received < 0) {
+            if (errno == EINTR) { continue; }
+            throw_errno("Client: recv");
+        }
+        if (received == 0) {
+            throw std::system_error(ECONNRESET, std::generic_category(), "Client: connection closed by the daemon");
+        }
+        bytes += received;
+        size -= static_cast<std::size_t>(received);
+    }
+}
+
+}  // namespace grafpe::service
+
+#endif
@@ -0,0 +1,330 @@
+/*
+ * author: Adam Budziak
+ */
+
+#include <grafpe/service/Server.hpp>
+
+#if defined(__linux__)
+
+#include <cerrno>
+#include <cstring>
+#include <system_error>
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace grafpe::service {
+
+namespace {
+
+constexpr std::size_t READ_CHUNK = 64u << 10u;
+// enough for the largest request
+constexpr std::size_t READ_LIMIT = sizeof(request_header) + MAX_BATCH * sizeof(uint64_t) + READ_CHUNK;
+constexpr int MAX_EVENTS = 64;
+
+[[noreturn]] void throw_errno(const char* what) {
+    throw std::system_error(errno, std::generic_category(), what);
+}
+
+[[noreturn]] void throw_in_use(const std::string& path) {
+    throw std::system_error(EADDRINUSE, std::generic_category(), "Server: address in use: " + path);
+}
+
+/**
+ * Removes the socket file left at the address by a daemon that is gone.
+ * Anything else at the path (a regular file, the socket of a running daemon) is left alone.
+ */
+void remove_stale_socket(const std::string& path, const sockaddr_un& address) {
+    struct stat info {};
+    if (lstat(path.c_str(), &info) < 0) {
+        if (errno == ENOENT) { return; }
+        throw_errno("Server: lstat");
+    }
+    if (!S_ISSOCK(info.st_mode)) {
+        throw_in_use(path);
+    }
+
+    const auto probe = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (probe < 0) {
+        throw_errno("Server: socket");
+    }
+    const auto connected = connect(probe, reinterpret_cast<const sockaddr*>(&address), sizeof(address));
+    const auto error = errno;
+    close(probe);
+    if (connected == 0 || error != ECONNREFUSED) {
+        throw_in_use(path);
+    }
+    unlink(path.c_str());
+}
+
+}  // namespace
+
+
+Server::Server(std::string socket_path, crypters_type crypters)
+  : m_path {std::move(socket_path)}, m_crypters {std::move(crypters)} {
+    sockaddr_un address {};
+    address.sun_family = AF_UNIX;
+    if (m_path.size() >= sizeof(address.sun_path)) {
+        throw std::invalid_argument("Server: socket path too long");
+    }
+    std::memcpy(address.sun_path, m_path.c_str(), m_path.size() + 1);
+
+    try {
+        if ((m_listen_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0)) < 0) {
+            throw_errno("Server: socket");
+        }
+        remove_stale_socket(m_path, address);
+        if (bind(m_listen_fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+            throw_errno("Server: bind");
+        }
+        struct stat info {};
+        if (stat(m_path.c_str(), &info) < 0) {
+            throw_errno("Server: stat");
+        }
+        m_device = info.st_dev;
+        m_inode = info.st_ino;
+        if (listen(m_listen_fd, SOMAXCONN) < 0) {
+            throw_errno("Server: listen");
+        }
+        if ((m_stop_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)) < 0) {
+            throw_errno("Server: eventfd");
+        }
+        if ((m_epoll_fd = epoll_create1(EPOLL_CLOEXEC)) < 0) {
+            throw_errno("Server: epoll_create1");
+        }
+        for (auto fd : {m_listen_fd, m_stop_fd}) {
+            epoll_event event {};
+            event.events = EPOLLIN;
+            event.data.fd = fd;
+            if (epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, fd, &event) < 0) {
+                throw_errno("Server: epoll_ctl");
+            }
+        }
+    } catch (...) {
+        for (auto fd : {m_listen_fd, m_stop_fd, m_epoll_fd}) {
+            if (fd >= 0) { close(fd); }
+        }
+        throw;
+    }
+}
+
+
+Server::~Server() {
+    for (auto& [fd, connection] : m_connections) {
+        close(fd);
+    }
+    close(m_epoll_fd);
+    close(m_stop_fd);
+    close(m_listen_fd);
+    // the path may have been taken over in the meantime
+    struct stat info {};
+    if (lstat(m_path.c_str(), &info) == 0 && S_ISSOCK(info.st_mode)
+        && info.st_dev == m_device && info.st_ino == m_inode) {
+        unlink(m_path.c_str());
+    }
+}
+
+
+void Server::stop() noexcept {
+    uint64_t one = 1;
+    // the only possible failure is an overflow of the counter, which still wakes up the loop
+    [[maybe_unused]] auto written = write(m_stop_fd, &one, sizeof(one));
+}
+
+
+void Server::run() {
+    epoll_event events[MAX_EVENTS];
+    for (;;) {
+        const auto ready = epoll_wait(m_epoll_fd, events, MAX_EVENTS, -1);
+        if (ready < 0) {
+            if (errno == EINTR) { continue; }
+            throw_errno("Server: epoll_wait");
+        }
+
+        for (int i = 0; i < ready; ++i) {
+            const auto fd = events[i].data.fd;
+            if (fd == m_stop_fd) {
+                uint64_t counter;
+                [[maybe_unused]] auto read_cnt = read(m_stop_fd, &counter, sizeof(counter));
+                return;
+            }
+            if (fd == m_listen_fd) {
+                accept_all();
+                continue;
+            }
+
+            auto it = m_connections.find(fd);
+            if (it == m_connections.end()) { continue; }
+            auto& connection = it->second;
+
+            if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) {
+                on_readable(fd, connection);
+            }
+            if (m_connections.count(fd) && (events[i].events & EPOLLOUT)) {
+                flush(fd, connection);
+            }
+        }
+    }
+}
+
+
+void Server::accept_all() {
+    for (;;) {
+        const auto fd = accept4(m_listen_fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) { return; }
+            // the client has gone before it was accepted, or the process is out of descriptors
+            if (errno == ECONNABORTED || errno == EINTR || errno == EMFILE || errno == ENFILE) { return; }
+            throw_errno("Server: accept4");
+        }
+
+        epoll_event event {};
+        event.events = EPOLLIN;
+        event.data.fd = fd;
+        if (epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, fd, &event) < 0) {
+            close(fd);
+            continue;
+        }
+        connection_t connection;
+        connection.events = EPOLLIN;
+        m_connections.emplace(fd, std::move(connection));
+    }
+}
+
+
+void Server::on_readable(int fd, connection_t& connection) {
+    auto& input = connection.input;
+    bool eof = false;
+    // the rest is read in the next iteration of the loop (epoll is level-triggered)
+    while (input.size() < READ_LIMIT) {
+        const auto size = input.size();
+        input.resize(size + READ_CHUNK);
+        const auto received = recv(fd, input.data() + size, READ_CHUNK, 0);
+        input.resize(size + static_cast<std::size_t>(std::max<ssize_t>(received, 0)));
+
+        if (received > 0) { continue; }
+        if (received == 0) {
+            eof = true;
+            break;
+        }
+        if (errno == EINTR) { continue; }
+        if (errno == EAGAIN || errno == EWOULDBLOCK) { break; }
+        close_connection(fd);
+        return;
+    }
+
+    std::size_t consumed = 0;
+    while (!connection.closing && input.size() - consumed >= sizeof(request_header)) {
+        request_header request;
+        std::memcpy(&request, input.data() + consumed, sizeof(request));
+
+        if (request.count > MAX_BATCH) {
+            response_header response {status_t::too_large, request.id, 0, 0};
+            const auto bytes = reinterpret_cast<const uint8_t*>(&response);
+            connection.output.insert(connection.output.end(), bytes, bytes + sizeof(response));
+            connection.closing = true;
+            break;
+        }
+
+        const auto frame_size = sizeof(request_header) + std::size_t{request.count} * sizeof(uint64_t);
+        if (input.size() - consumed < frame_size) { break; }
+
+        handle(request, input.data() + consumed + sizeof(request_header), connection.output);
+        consumed += frame_size;
+    }
+    input.erase(input.begin(), input.begin() + static_cast<std::ptrdiff_t>(consumed));
+
+    // the responses to the complete requests are still sent after the peer has finished writing
+    if (eof) {
+        connection.closing = true;
+    }
+    flush(fd, connection);
+}
+
+
+void Server::handle(const request_header& request, const uint8_t* values, std::vector<uint8_t>& output) {
+    response_header response {status_t::ok, request.id, request.count, 0};
+
+    if (request.crypter >= m_crypters.size() || !m_crypters[request.crypter]) {
+        response.status = status_t::unknown_crypter;
+    } else if (request.op != op_t::encrypt && request.op != op_t::decrypt) {
+        response.status = status_t::unknown_op;
+    } else {
+        // the values in the input buffer aren't aligned
+        m_values.resize(request.count);
+        std::memcpy(m_values.data(), values, request.count * sizeof(uint64_t));
+        try {
+            const auto& crypter = *m_crypters[request.crypter];
+            const auto tweak = tweak_t{request.tweak};
+            if (request.op == op_t::encrypt) {
+                crypter.encrypt_batch(m_values.data(), m_values.data(), m_values.size(), tweak);
+            } else {
+                crypter.decrypt_batch(m_values.data(), m_values.data(), m_values.size(), tweak);
+            }
+        } catch (const std::exception&) {
+            response.status = status_t::invalid_value;
+        }
+    }
+    if (response.status != status_t::ok) {
+        response.count = 0;
+    }
+
+    const auto header = reinterpret_cast<const uint8_t*>(&response);
+    output.insert(output.end(), header, header + sizeof(response));
+    const auto payload = reinterpret_cast<const uint8_t*>(m_values.data());
+    output.insert(output.end(), payload, payload + response.count * sizeof(uint64_t));
+}
+
+
+void Server::flush(int fd, connection_t& connection) {
+    auto& output = connection.output;
+    while (connection.sent < output.size()) {
+        const auto sent = send(fd, output.data() + connection.sent, output.size() - connection.sent, MSG_NOSIGNAL);
+        if (sent < 0) {
+            if (errno == EINTR) { continue; }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) { break; }
+            close_connection(fd);
+            return;
+        }
+        connection.sent += static_cast<std::size_t>(sent);
+    }
+
+    if (connection.sent == output.size()) {
+        output.clear();
+        connection.sent = 0;
+        if (connection.closing) {
+            close_connection(fd);
+            return;
+        }
+    }
+    update_events(fd, connection);
+}
+
+
+void Server::update_events(int fd, connection_t& connection) {
+    const auto pending = connection.output.size() - connection.sent;
+    const auto events = (!connection.closing && pending <= MAX_PENDING_OUTPUT ? EPOLLIN : 0u)
+                        | (pending > 0 ? EPOLLOUT : 0u);
+    if (events == connection.events) { return; }
+
+    epoll_event event {};
+    event.events = events;
+    event.data.fd = fd;
+    epoll_ctl(m_epoll_fd, EPOLL_CTL_MOD, fd, &event);
+    connection.events = events;
+}
+
+
+void Server::close_connection(int fd) {
+    epoll_ctl(m_epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+    close(fd);
+    m_connections.erase(fd);
+}
+
+}  // namespace grafpe::service
+
+#endif
@@ -0,0 +1,38 @@
+/*
+ * author: Adam Budziak
+ */
+
+#pragma once
+
+#include <cstddef>
+
+namespace pur {
+
+/**
+ * A non-owning, read-only view of a contiguous array of values.
+ */
+template <typename T>
+class array_view {
+    const T* m_data = nullptr;
+    std::size_t m_size = 0;
+
+ public:
+    using value_type = T;
+    using const_iterator = const T*;
+
+    array_view() = default;
+    array_view(const T* data, std::size_t size) noexcept : m_data {data}, m_size {size} {  }
+
+    template<typename Container>
+    explicit array_view(const Container& cont) noexcept : m_data {cont.data()}, m_size {cont.size()} {  }
+
+    const T& operator[](std::size_t index) const noexcept { return m_data[index]; }
+    const T* data() const noexcept { return m_data; }
+    std::size_t size() const noexcept { return m_size; }
+    bool empty() const noexcept { return m_size == 0; }
+
+    const_iterator begin() const noexcept { return m_data; }
+    const_iterator end() const noexcept { return m_data + m_size; }
+};
+
+}  // namespace pur
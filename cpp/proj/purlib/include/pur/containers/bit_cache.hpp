@@ -0,0 +1,58 @@
+/*
+ * author: Adam Budziak
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <pur/optional/Optional.hpp>
+#include "cache_statistics.hpp"
+
+namespace pur {
+
+/**
+ * A fixed-capacity, direct-mapped cache of boolean values.
+ *
+ * Every key is mapped to exactly one slot, so inserting a key whose slot
+ * is taken by another key evicts the old one. The values and the occupancy
+ * flags are packed into 64-bit words, hence the memory used depends only
+ * on the capacity, never on the number of insertions.
+ *
+ * The capacity is rounded up to the nearest power of two.
+ */
+class bit_cache {
+    using cell_t = uint64_t;
+    static constexpr auto bit_size = sizeof(cell_t) * 8;
+
+ public:
+    using key_type = std::size_t;
+
+    explicit bit_cache(size_t capacity);
+
+    /**
+     * Looks the key up and updates the hit/miss counters.
+     * @return pur::Optional holding the cached value, empty on a miss.
+     */
+    Optional<bool> find(key_type key);
+
+    void insert(key_type key, bool value);
+    void clear();
+
+    size_t capacity() const { return m_keys.size(); }
+    const cache_statistics& stats() const { return m_stats; }
+
+ private:
+    std::vector<key_type> m_keys;
+    std::vector<cell_t> m_occupied;
+    std::vector<cell_t> m_values;
+    size_t m_mask;
+    cache_statistics m_stats;
+
+    size_t slot(key_type key) const;
+    bool occupied(size_t slot) const;
+};
+
+}  // namespace pur
@@ -0,0 +1,26 @@
+/*
+ * author: Adam Budziak
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace pur {
+
+/**
+ * Counters describing how well a cache serves its lookups.
+ */
+struct cache_statistics {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0;
+
+    uint64_t lookups() const { return hits + misses; }
+
+    double hit_rate() const {
+        return lookups() ? static_cast<double>(hits) / static_cast<double>(lookups()) : 0.0;
+    }
+};
+
+}  // namespace pur
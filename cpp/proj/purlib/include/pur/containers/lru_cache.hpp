@@ -0,0 +1,139 @@
+/*
+ * author: Adam Budziak
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+#include "cache_statistics.hpp"
+
+namespace pur {
+
+/**
+ * A thread-safe least-recently-used cache with a bounded total cost.
+ *
+ * Every value is inserted together with its cost (e.g. its size in bytes),
+ * and the least recently used values are evicted as long as the sum
+ * of the costs exceeds the capacity. Values are handed out as shared
+ * pointers, so an evicted value stays alive as long as somebody uses it.
+ */
+template <typename Key, typename Value, typename Hash = std::hash<Key>>
+class lru_cache {
+ public:
+    using key_type = Key;
+    using value_ptr = std::shared_ptr<const Value>;
+
+    explicit lru_cache(size_t capacity): m_capacity {capacity} {  }
+
+    lru_cache(const lru_cache&) = delete;
+    lru_cache& operator=(const lru_cache&) = delete;
+
+    /**
+     * Looks the key up and updates the hit/miss counters.
+     * @return the cached value or nullptr on a miss.
+     */
+    value_ptr find(const key_type& key);
+
+    /**
+     * Inserts the value unless the key is already present.
+     * A value more costly than the whole capacity is not stored at all.
+     * @return the value stored under the key.
+     */
+    value_ptr insert(const key_type& key, Value value, size_t cost = 1);
+
+    void clear();
+
+    size_t capacity() const noexcept { return m_capacity; }
+    size_t size() const;
+    size_t cost() const;
+    cache_statistics stats() const;
+
+ private:
+    struct entry {
+        key_type key;
+        value_ptr value;
+        size_t cost;
+    };
+
+    using entries_t = std::list<entry>;
+
+    const size_t m_capacity;
+    size_t m_cost = 0;
+    entries_t m_entries;
+    std::unordered_map<key_type, typename entries_t::iterator, Hash> m_index;
+    cache_statistics m_stats;
+    mutable std::mutex m_mutex;
+};
+
+
+template<typename Key, typename Value, typename Hash>
+auto lru_cache<Key, Value, Hash>::find(const key_type& key) -> value_ptr {
+    std::lock_guard<std::mutex> lck {m_mutex};
+    auto iter = m_index.find(key);
+    if (iter == m_index.end()) {
+        ++m_stats.misses;
+        return nullptr;
+    }
+    ++m_stats.hits;
+    m_entries.splice(m_entries.begin(), m_entries, iter->second);
+    return iter->second->value;
+}
+
+template<typename Key, typename Value, typename Hash>
+auto lru_cache<Key, Value, Hash>::insert(const key_type& key, Value value, size_t cost) -> value_ptr {
+    auto ptr = std::make_shared<const Value>(std::move(value));
+
+    std::lock_guard<std::mutex> lck {m_mutex};
+    if (auto iter = m_index.find(key); iter != m_index.end()) {
+        return iter->second->value;
+    }
+    if (cost > m_capacity) {
+        return ptr;
+    }
+    while (m_cost + cost > m_capacity) {
+        m_cost -= m_entries.back().cost;
+        m_index.erase(m_entries.back().key);
+        m_entries.pop_back();
+        ++m_stats.evictions;
+    }
+    m_entries.push_front(entry{key, ptr, cost});
+    m_index.emplace(key, m_entries.begin());
+    m_cost += cost;
+    return ptr;
+}
+
+template<typename Key, typename Value, typename Hash>
+void lru_cache<Key, Value, Hash>::clear() {
+    std::lock_guard<std::mutex> lck {m_mutex};
+    m_entries.clear();
+    m_index.clear();
+    m_cost = 0;
+    m_stats = {};
+}
+
+template<typename Key, typename Value, typename Hash>
+size_t lru_cache<Key, Value, Hash>::size() const {
+    std::lock_guard<std::mutex> lck {m_mutex};
+    return m_entries.size();
+}
+
+template<typename Key, typename Value, typename Hash>
+size_t lru_cache<Key, Value, Hash>::cost() const {
+    std::lock_guard<std::mutex> lck {m_mutex};
+    return m_cost;
+}
+
+template<typename Key, typename Value, typename Hash>
+cache_statistics lru_cache<Key, Value, Hash>::stats() const {
+    std::lock_guard<std::mutex> lck {m_mutex};
+    return m_stats;
+}
+
+}  // namespace pur
@@ -0,0 +1,84 @@
+/*
+ * author: Adam Budziak
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace pur {
+
+/**
+ * A monotonic (bump-pointer) memory region.
+ *
+ * Memory is handed out from large blocks and never returned one allocation at a time;
+ * all of it is released at once when the arena is destroyed. Allocations larger
+ * than the block size get blocks of their own.
+ *
+ * Not thread-safe, every thread should use its own arena.
+ */
+class arena {
+ public:
+    static constexpr std::size_t DEFAULT_BLOCK_SIZE = 64u << 10u;
+
+    explicit arena(std::size_t block_size = DEFAULT_BLOCK_SIZE);
+    arena(const arena&) = delete;
+    arena& operator=(const arena&) = delete;
+
+    void* allocate(std::size_t bytes, std::size_t alignment = alignof(std::max_align_t));
+
+    /**
+     * Bytes handed out so far (without the alignment padding).
+     */
+    std::size_t allocated_bytes() const noexcept { return m_allocated; }
+
+    /**
+     * Bytes of all the blocks owned by the arena.
+     */
+    std::size_t reserved_bytes() const noexcept { return m_reserved; }
+
+ private:
+    std::size_t m_block_size;
+    std::vector<std::unique_ptr<std::byte[]>> m_blocks;
+    std::byte* m_current = nullptr;
+    std::size_t m_left = 0;
+    std::size_t m_allocated = 0;
+    std::size_t m_reserved = 0;
+};
+
+
+/**
+ * Standard allocator taking memory from a shared arena; deallocation is a no-op.
+ * Every copy of the allocator keeps the arena alive, so e.g. a shared_ptr control block
+ * allocated with it keeps the arena alive as long as the control block exists.
+ */
+template <typename T>
+class arena_allocator {
+    template <typename U> friend class arena_allocator;
+    std::shared_ptr<arena> m_arena;
+
+ public:
+    using value_type = T;
+
+    explicit arena_allocator(std::shared_ptr<arena> arena) noexcept : m_arena {std::move(arena)} {}
+
+    template <typename U>
+    arena_allocator(const arena_allocator<U>& other) noexcept : m_arena {other.m_arena} {}  // NOLINT
+
+    T* allocate(std::size_t n) {
+        return static_cast<T*>(m_arena->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T*, std::size_t) noexcept {}
+
+    template <typename U>
+    bool operator==(const arena_allocator<U>& other) const noexcept { return m_arena == other.m_arena; }
+
+    template <typename U>
+    bool operator!=(const arena_allocator<U>& other) const noexcept { return m_arena != other.m_arena; }
+};
+
+}  // namespace pur
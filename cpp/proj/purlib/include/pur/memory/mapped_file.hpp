@@ -0,0 +1,39 @@
+/*
+ * author: Adam Budziak
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace pur {
+
+/**
+ * A whole file mapped read-only into memory.
+ *
+ * The pages are loaded lazily by the OS and shared between the processes mapping
+ * the same file, so opening even a large file costs (almost) nothing.
+ * On the systems without mmap the file is read into an owned buffer instead.
+ * std::system_error is thrown if the file can't be opened or mapped.
+ */
+class mapped_file {
+    const uint8_t* m_data = nullptr;
+    std::size_t m_size = 0;
+    // the contents, if the file isn't mapped
+    std::vector<uint8_t> m_buffer;
+
+ public:
+    explicit mapped_file(const std::string& path);
+    ~mapped_file();
+
+    mapped_file(const mapped_file&) = delete;
+    mapped_file& operator=(const mapped_file&) = delete;
+
+    const uint8_t* data() const noexcept { return m_data; }
+    std::size_t size() const noexcept { return m_size; }
+};
+
+}  // namespace pur
@@ -0,0 +1,67 @@
+/*
+ * author: Adam Budziak
+ */
+
+#include <algorithm>
+#include <pur/containers/bit_cache.hpp>
+
+namespace pur {
+
+namespace {
+
+size_t round_up_pow2(size_t value) {
+    size_t result = 1;
+    while (result < value) { result <<= 1u; }
+    return result;
+}
+
+}  // namespace
+
+bit_cache::bit_cache(size_t capacity)
+  : m_keys(round_up_pow2(capacity)),
+    m_occupied((m_keys.size() - 1) / bit_size + 1),
+    m_values(m_occupied.size()),
+    m_mask {m_keys.size() - 1} { }
+
+Optional<bool> bit_cache::find(key_type key) {
+    const auto index = slot(key);
+    if (occupied(index) && m_keys[index] == key) {
+        ++m_stats.hits;
+        return static_cast<bool>(m_values[index / bit_size] & (cell_t(1) << index % bit_size));
+    }
+    ++m_stats.misses;
+    return {};
+}
+
+void bit_cache::insert(key_type key, bool value) {
+    const auto index = slot(key);
+    const auto mask = cell_t(1) << index % bit_size;
+    if (occupied(index) && m_keys[index] != key) {
+        ++m_stats.evictions;
+    }
+    m_keys[index] = key;
+    m_occupied[index / bit_size] |= mask;
+    if (value) {
+        m_values[index / bit_size] |= mask;
+    } else {
+        m_values[index / bit_size] &= ~mask;
+    }
+}
+
+void bit_cache::clear() {
+    std::fill(m_occupied.begin(), m_occupied.end(), 0);
+    m_stats = {};
+}
+
+size_t bit_cache::slot(key_type key) const {
+    // Fibonacci hashing, so that keys with a common stride don't share slots
+    uint64_t mixed = static_cast<uint64_t>(key) * 0x9E3779B97F4A7C15ull;
+    mixed ^= mixed >> 32u;
+    return static_cast<size_t>(mixed) & m_mask;
+}
+
+bool bit_cache::occupied(size_t slot) const {
+    return static_cast<bool>(m_occupied[slot / bit_size] & (cell_t(1) << slot % bit_size));
+}
+
+}  // namespace pur
@@ -0,0 +1,37 @@
+/*
+ * author: Adam Budziak
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <new>
+
+#include <pur/memory/arena.hpp>
+
+namespace pur {
+
+arena::arena(std::size_t block_size) : m_block_size {std::max<std::size_t>(block_size, 1)} {  }
+
+void* arena::allocate(std::size_t bytes, std::size_t alignment) {
+    auto padding = [this, alignment] {
+        auto address = reinterpret_cast<std::uintptr_t>(m_current);
+        return (alignment - address % alignment) % alignment;
+    };
+
+    if (m_current == nullptr || padding() + bytes > m_left) {
+        auto size = std::max(m_block_size, bytes + alignment);
+        m_blocks.emplace_back(new std::byte[size]);
+        m_current = m_blocks.back().get();
+        m_left = size;
+        m_reserved += size;
+    }
+
+    auto pad = padding();
+    auto result = m_current + pad;
+    m_current += pad + bytes;
+    m_left -= pad + bytes;
+    m_allocated += bytes;
+    return result;
+}
+
+}  // namespace pur
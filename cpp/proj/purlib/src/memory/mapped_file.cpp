@@ -0,0 +1,79 @@
+/*
+ * author: Adam Budziak
+ */
+
+#include <cerrno>
+#include <system_error>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <fstream>
+#endif
+
+#include <pur/memory/mapped_file.hpp>
+
+namespace pur {
+
+#if defined(__unix__) || defined(__APPLE__)
+
+mapped_file::mapped_file(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throw std::system_error(errno, std::generic_category(), "mapped_file: can't open " + path);
+    }
+
+    struct stat info {};
+    if (::fstat(fd, &info) < 0) {
+        auto error = errno;
+        ::close(fd);
+        throw std::system_error(error, std::generic_category(), "mapped_file: can't stat " + path);
+    }
+
+    m_size = static_cast<std::size_t>(info.st_size);
+    // an empty file can't be mapped, it is just empty
+    if (m_size > 0) {
+        void* data = ::mmap(nullptr, m_size, PROT_READ, MAP_SHARED, fd, 0);
+        if (data == MAP_FAILED) {
+            auto error = errno;
+            ::close(fd);
+            throw std::system_error(error, std::generic_category(), "mapped_file: can't map " + path);
+        }
+        m_data = static_cast<const uint8_t*>(data);
+    }
+    // the mapping stays valid after the descriptor is closed
+    ::close(fd);
+}
+
+mapped_file::~mapped_file() {
+    if (m_data != nullptr) {
+        ::munmap(const_cast<uint8_t*>(m_data), m_size);
+    }
+}
+
+#else
+
+mapped_file::mapped_file(const std::string& path) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) {
+        throw std::system_error(std::make_error_code(std::errc::no_such_file_or_directory),
+                                "mapped_file: can't open " + path);
+    }
+
+    m_buffer.resize(static_cast<std::size_t>(file.tellg()));
+    file.seekg(0);
+    if (!file.read(reinterpret_cast<char*>(m_buffer.data()), static_cast<std::streamsize>(m_buffer.size()))) {
+        throw std::system_error(std::make_error_code(std::errc::io_error), "mapped_file: can't read " + path);
+    }
+    m_size = m_buffer.size();
+    m_data = m_size > 0 ? m_buffer.data() : nullptr;
+}
+
+mapped_file::~mapped_file() = default;
+
+#endif
+
+}  // namespace pur
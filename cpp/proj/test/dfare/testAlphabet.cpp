@@ -3,6 +3,7 @@
  */
 
 #include <dfare/common/Alphabet.hpp>
+#include <dfare/common/AlphabetCodec.hpp>
 #include "../catch/catch.hpp"
 
 TEST_CASE("Test alphabet invariants") {
@@ -39,3 +40,56 @@ TEST_CASE("Test alphabet invariants") {
         REQUIRE(a.chr(a.ord(c)) == c);
     }
 }
+
+TEST_CASE("Characters outside of the alphabet") {
+    using namespace dfare;
+
+    Alphabet a{"xyz"};
+    REQUIRE(a.ord('a') == 3);
+    REQUIRE(a.ord('\xff') == 3);
+
+    a.add_character('\xff');
+    REQUIRE(a.ord('\xff') == 0);
+    REQUIRE(a.ord('x') == 1);
+    REQUIRE(a.ord('a') == 4);
+}
+
+TEST_CASE("Alphabet codec") {
+    using namespace dfare;
+
+    Alphabet a{"zyx-a\xff"};
+    AlphabetCodec codec{a};
+    REQUIRE(codec.size() == a.characters().size());
+
+    std::string text = "xa-zz\xffy";
+    std::vector<uint64_t> ranks(text.size());
+    codec.encode(text, ranks.data());
+    for (std::size_t i = 0; i < text.size(); ++i) {
+        REQUIRE(ranks[i] == a.ord(text[i]));
+    }
+
+    std::string decoded(text.size(), '\0');
+    codec.decode(ranks.data(), ranks.size(), decoded.data());
+    REQUIRE(decoded == text);
+
+    SECTION("Invalid characters and ranks") {
+        REQUIRE_THROWS_AS(codec.encode("xab", ranks.data()), std::out_of_range);
+        ranks[2] = codec.size();
+        REQUIRE_THROWS_AS(codec.decode(ranks.data(), 3, decoded.data()), std::out_of_range);
+        ranks[2] = 256 + 1;
+        REQUIRE_THROWS_AS(codec.decode(ranks.data(), 3, decoded.data()), std::out_of_range);
+    }
+
+    SECTION("Full byte alphabet") {
+        std::string bytes;
+        for (int byte = 0; byte < 256; ++byte) {
+            bytes += static_cast<char>(byte);
+        }
+        AlphabetCodec full{Alphabet{bytes}};
+        std::vector<uint8_t> byte_ranks(bytes.size());
+        full.encode(bytes, byte_ranks.data());
+        std::string back(bytes.size(), '\0');
+        full.decode(byte_ranks.data(), byte_ranks.size(), back.data());
+        REQUIRE(back == bytes);
+    }
+}
@@ -5,8 +5,12 @@
 #include "../catch/catch.hpp"
 
 #include <dfare/dfa/DFA.hpp>
+#include <dfare/dfa/RankedDFA.hpp>
+#include <dfare/dfa/checksums.hpp>
 #include <dfare/regexp/from_string.hpp>
 #include <iostream>
+#include <string>
+#include <vector>
 
 TEST_CASE("Test build DFA") {
     using namespace dfare::dfa;
@@ -15,3 +19,174 @@ TEST_CASE("Test build DFA") {
     auto dfa = DFA::from_regex(regexp::from_string("ab+ac"));
     std::cout << dfa << std::endl;
 }
+
+TEST_CASE("DFA minimization") {
+    using namespace dfare::dfa;
+    using namespace dfare;
+
+    const auto all_words = [](const std::string& characters, std::size_t max_length) {
+        std::vector<std::string> words {""};
+        for (std::size_t i = 0; i < words.size(); ++i) {
+            if (words[i].size() == max_length) { continue; }
+            for (char c : characters) {
+                words.push_back(words[i] + c);
+            }
+        }
+        return words;
+    };
+
+    for (auto regex : {"(ab+ba)*+(a+b)(a+b)", "Adam_+Ewa__+Alice+Bob__", "a(b+c)*d", "(a+b)*a(a+b)*+b*"}) {
+        auto dfa = DFA::from_regex(regexp::from_string(regex));
+        auto minimal = dfa.minimized();
+
+        REQUIRE(minimal.built_states_count() == dfa.states.size());
+        REQUIRE(minimal.states.size() <= dfa.states.size());
+        REQUIRE(minimal.minimized().states.size() == minimal.states.size());
+
+        for (auto& word : all_words(dfa.alphabet.characters() + "x", 5)) {
+            REQUIRE(minimal.accepts(word) == dfa.accepts(word));
+        }
+    }
+
+    SECTION("Equivalent states are merged") {
+        auto dfa = DFA::from_regex(regexp::from_string("(ab+ba)*+(a+b)(a+b)"), true);
+        REQUIRE(dfa.built_states_count() == 10);
+        REQUIRE(dfa.states.size() == 8);
+        REQUIRE(dfa.get_transition(dfa.run("bb"), 'b') == dfa.dead_state());
+
+        auto all = DFA::from_regex(regexp::from_string("(a+b)*a(a+b)*+b*"), true);
+        REQUIRE(all.states.size() == 2);
+        REQUIRE(all.accepting_states == DFA::accept_states_t{0});
+    }
+}
+
+
+TEST_CASE("Worklist DFA build") {
+    using namespace dfare::dfa;
+    using namespace dfare;
+
+    const std::string digit = "(0+1+2+3+4+5+6+7+8+9)";
+    const std::string letter = "(a+b+c+d+e+f+g+h+i+j+k+l+m+n+o+p+q+r+s+t+u+v+w+x+y+z)";
+    std::string regex = letter + letter;
+    for (int i = 0; i < 12; ++i) {
+        regex += digit;
+    }
+    regex += "(" + letter + "+" + digit + ")*";
+
+    auto sequential = DFA::from_regex(regexp::from_string(regex), false, 1);
+
+    SECTION("States are numbered in BFS order") {
+        REQUIRE(sequential.run("0") == 1);  // digits go first in the alphabet
+        REQUIRE(sequential.run("a") == 2);
+        REQUIRE(sequential.run("ab") == 3);
+        REQUIRE(sequential.run("ab0123456789") == 13);
+        REQUIRE(sequential.accepts("ab012345678901x9z"));
+        REQUIRE(!sequential.accepts("ab01234567890"));
+    }
+
+    SECTION("Numbering doesn't depend on the number of threads") {
+        for (std::size_t threads : {2, 3, 8}) {
+            auto parallel = DFA::from_regex(regexp::from_string(regex), false, threads);
+            REQUIRE(parallel.states.size() == sequential.states.size());
+            for (std::size_t state = 0; state < sequential.states.size(); ++state) {
+                REQUIRE(parallel.states[state] == sequential.states[state]);
+                // neither the arena of the build nor those of the workers are kept alive
+                REQUIRE(!regexp::detail::in_arena(parallel.states[state]));
+            }
+            REQUIRE(parallel.edges == sequential.edges);
+            REQUIRE(parallel.accepting_states == sequential.accepting_states);
+        }
+    }
+
+    SECTION("Long chains of states") {
+        auto chain = DFA::from_regex(regexp::from_string(std::string(20000, 'a')));
+        REQUIRE(chain.states.size() == 20003);
+        REQUIRE(chain.accepts(std::string(20000, 'a')));
+    }
+}
+
+
+TEST_CASE("DFA products and complement") {
+    using namespace dfare::dfa;
+    using namespace dfare;
+
+    std::vector<std::string> words {""};
+    for (std::size_t i = 0; i < words.size(); ++i) {
+        if (words[i].size() == 6) { continue; }
+        for (char c : std::string{"abc"}) {
+            words.push_back(words[i] + c);
+        }
+    }
+
+    auto starts = DFA::from_regex(regexp::from_string("a(a+b)*"));
+    auto ends = DFA::from_regex(regexp::from_string("(b+c)*b"));
+
+    auto both = starts.intersected(ends);
+    auto any = starts.united(ends);
+    auto not_starts = starts.complemented();
+
+    REQUIRE(both.alphabet == Alphabet{"abc"});
+    REQUIRE(not_starts.alphabet == starts.alphabet);
+    for (auto& word : words) {
+        REQUIRE(both.accepts(word) == (starts.accepts(word) && ends.accepts(word)));
+        REQUIRE(any.accepts(word) == (starts.accepts(word) || ends.accepts(word)));
+        if (word.find('c') == std::string::npos) {
+            REQUIRE(not_starts.accepts(word) == !starts.accepts(word));
+        } else {
+            REQUIRE(!not_starts.accepts(word));
+        }
+    }
+
+    REQUIRE(both.states.size() == both.minimized().states.size());
+    REQUIRE(both.get_transition(both.run("ab"), 'c') == both.dead_state());
+    REQUIRE(starts.complemented().complemented().states.size() == starts.minimized().states.size());
+    REQUIRE(starts.intersected(not_starts).states.size() == 1);
+}
+
+
+TEST_CASE("Checksum automata") {
+    using namespace dfare::dfa;
+    using namespace dfare;
+
+    const auto luhn_valid = [](const std::string& number) {
+        int sum = 0;
+        bool doubled = false;
+        for (auto it = number.rbegin(); it != number.rend(); ++it, doubled = !doubled) {
+            int digit = (*it - '0') * (doubled ? 2 : 1);
+            sum += digit > 9 ? digit - 9 : digit;
+        }
+        return sum % 10 == 0;
+    };
+
+    auto luhn = checksums::luhn();
+    auto mod7 = checksums::mod(7, 3);
+    for (uint64_t number = 0; number < 100000; number += 13) {
+        auto str = std::to_string(number);
+        REQUIRE(luhn.accepts(str) == luhn_valid(str));
+        REQUIRE(mod7.accepts(str) == (number % 7 == 3));
+    }
+    REQUIRE(luhn.accepts("4539578763621486"));
+    REQUIRE(!luhn.accepts("4539578763621487"));
+    REQUIRE(!luhn.accepts("45395787a3621486"));
+    REQUIRE(mod7.states.size() == 8);
+    REQUIRE_THROWS_AS(checksums::mod(7, 7), std::invalid_argument);
+
+    SECTION("Fixed-length numbers with a check digit are ranked exactly") {
+        const std::string digit = "(0+1+2+3+4+5+6+7+8+9)";
+        std::string format = "(1+2+3+4+5+6+7+8+9)";
+        for (int i = 1; i < 16; ++i) {
+            format += digit;
+        }
+
+        auto ccn = RankedDFA{DFA::from_regex(regexp::from_string(format), true).intersected(luhn), 16};
+        REQUIRE(ccn.max_rank == 900'000'000'000'000);
+        REQUIRE(ccn.unrank(0) == "1000000000000008");
+        REQUIRE(ccn.rank("4539578763621486") < ccn.max_rank);
+        REQUIRE(ccn.unrank(ccn.rank("4539578763621486")) == "4539578763621486");
+        for (uint64_t rank = 0; rank < ccn.max_rank; rank += 12'345'678'901) {
+            auto number = ccn.unrank(rank);
+            REQUIRE(luhn_valid(number));
+            REQUIRE(ccn.rank(number) == rank);
+        }
+    }
+}
@@ -3,8 +3,13 @@
  */
 
 #include <dfare/dfa/RankedDFA.hpp>
+#include <dfare/exceptions.hpp>
 #include <dfare/regexp/from_string.hpp>
+#include <filesystem>
+#include <fstream>
 #include <iostream>
+#include <thread>
+#include <vector>
 #include <pur/logger/stream_operators.hpp>
 #include "../catch/catch.hpp"
 
@@ -71,3 +76,157 @@ TEST_CASE("Rank-unrank") {
         REQUIRE(dfa.rank(dfa.unrank(i)) == i);
     }
 }
+
+TEST_CASE("RankedDFA rank table") {
+    using namespace dfare::dfa;
+    auto dfa = RankedDFA::from_string("(a+b)*c", 4);
+
+    REQUIRE(dfa.get_rank_table().size() == 5 * dfa.dfa.states.size());
+    REQUIRE(dfa.count(0, 4) == 8);
+    REQUIRE(dfa.count(0, 1) == 1);
+    REQUIRE(dfa.count(dfa.dfa.states.size() - 1, 4) == 0);
+    REQUIRE(dfa.max_rank == 8);
+
+    SECTION("Concurrent queries") {
+        std::vector<std::thread> workers;
+        std::vector<int> failures(4, 0);
+        for (int t = 0; t < 4; ++t) {
+            workers.emplace_back([&dfa, &failures, t] {
+                for (int repeat = 0; repeat < 100; ++repeat) {
+                    for (size_t i = 0; i < dfa.max_rank; ++i) {
+                        failures[t] += dfa.rank(dfa.unrank(i)) != i;
+                    }
+                }
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        REQUIRE(failures == std::vector<int>(4, 0));
+    }
+}
+
+TEST_CASE("Rank-unrank with a wide alphabet") {
+    using namespace dfare::dfa;
+    auto dfa = RankedDFA::from_string("(a+b+c+d+e+f+g+h+i+j+k+l+m+n+o+p)(x+y+z+0+1+2+3+4+5+6+7+8+9)*", 4);
+
+    REQUIRE(dfa.max_rank == 16 * 13 * 13 * 13);
+    REQUIRE(dfa.rank("a000") == 0);
+    REQUIRE(dfa.rank("a009") == 9);
+    REQUIRE(dfa.unrank(dfa.max_rank - 1) == "pzzz");
+
+    for (size_t i = 0; i < dfa.max_rank; i += 37) {
+        REQUIRE(dfa.rank(dfa.unrank(i)) == i);
+    }
+}
+
+TEST_CASE("Compiled RankedDFA cache") {
+    using namespace dfare::dfa;
+    namespace fs = std::filesystem;
+
+    const std::string regex = "(a+b+c+d+e+f+g+h+i+j+k+l+m+n+o+p)(x+y+z+0+1+2+3+4+5+6+7+8+9)*";
+    const auto path = (fs::temp_directory_path() / "dfare_test_cache.dfa").string();
+    fs::remove(path);
+
+    auto built = RankedDFA::from_string_cached(regex, 4, path);
+    REQUIRE(fs::exists(path));
+    auto loaded = RankedDFA::from_string_cached(regex, 4, path);
+
+    SECTION("The loaded DFA is the same") {
+        REQUIRE(loaded.max_rank == built.max_rank);
+        REQUIRE(loaded.dfa.states.size() == built.dfa.states.size());
+        REQUIRE(loaded.dfa.built_states_count() == built.dfa.built_states_count());
+        REQUIRE(loaded.dfa.edges == built.dfa.edges);
+        REQUIRE(loaded.dfa.accepting_states == built.dfa.accepting_states);
+        REQUIRE(loaded.dfa.alphabet == built.dfa.alphabet);
+        REQUIRE(std::equal(loaded.get_rank_table().begin(), loaded.get_rank_table().end(),
+                           built.get_rank_table().begin(), built.get_rank_table().end()));
+
+        for (size_t i = 0; i < built.max_rank; i += 7) {
+            REQUIRE(loaded.unrank(i) == built.unrank(i));
+            REQUIRE(loaded.rank(built.unrank(i)) == i);
+        }
+        REQUIRE(!loaded.accepts("0ax"));
+        REQUIRE(loaded.accepts("p0x9"));
+    }
+
+    SECTION("Stale caches are detected") {
+        REQUIRE(RankedDFA::content_hash(regex, 4) != RankedDFA::content_hash(regex, 5));
+        REQUIRE_THROWS_AS(RankedDFA::load(path, RankedDFA::content_hash(regex, 5)), dfare::invalid_dfa_cache);
+
+        auto longer = RankedDFA::from_string_cached(regex, 5, path);
+        REQUIRE(longer.max_rank == 16 * 13 * 13 * 13 * 13);
+        REQUIRE(RankedDFA::load(path, RankedDFA::content_hash(regex, 5)).max_rank == longer.max_rank);
+    }
+
+    SECTION("Corrupted caches are detected") {
+        fs::resize_file(path, fs::file_size(path) - 8);
+        REQUIRE_THROWS_AS(RankedDFA::load(path, RankedDFA::content_hash(regex, 4)), dfare::invalid_dfa_cache);
+
+        std::ofstream {path, std::ios::binary | std::ios::trunc} << "not a DFA";
+        REQUIRE_THROWS_AS(RankedDFA::load(path, RankedDFA::content_hash(regex, 4)), dfare::invalid_dfa_cache);
+        REQUIRE(RankedDFA::from_string_cached(regex, 4, path).max_rank == built.max_rank);
+    }
+
+    SECTION("Caches that can't be written are skipped") {
+        const auto missing = (fs::temp_directory_path() / "dfare_missing_dir" / "cache.dfa").string();
+        REQUIRE(!fs::exists(fs::path{missing}.parent_path()));
+        REQUIRE(RankedDFA::from_string_cached(regex, 4, missing).max_rank == built.max_rank);
+        REQUIRE(!fs::exists(missing));
+    }
+
+    fs::remove(path);
+}
+
+TEST_CASE("Batch rank and unrank") {
+    using namespace dfare::dfa;
+    auto dfa = RankedDFA::from_string("(a+b+c+d+e+f+g+h+i+j+k+l+m+n+o+p)(x+y+z+0+1+2+3+4+5+6+7+8+9)*", 5);
+
+    std::vector<uint64_t> ranks;
+    for (uint64_t rank = 0; rank < dfa.max_rank; rank += 101) {
+        ranks.push_back(rank);
+    }
+    ranks.push_back(dfa.max_rank - 1);
+
+    auto words = dfa.unrank_many(ranks);
+    REQUIRE(words.size() == ranks.size() * 5);
+
+    std::vector<std::string_view> views;
+    for (std::size_t i = 0; i < ranks.size(); ++i) {
+        views.emplace_back(words.data() + i * 5, 5);
+        REQUIRE(views.back() == dfa.unrank(ranks[i]));
+    }
+    REQUIRE(dfa.rank_many(views) == ranks);
+
+    SECTION("Words of other lengths and characters") {
+        std::vector<std::string> odd {"a", "b00000", "px", "", "a0x9q", "azzzz", "p9999", "c0-00", "a0", "q0000"};
+        std::vector<std::string_view> odd_views(odd.begin(), odd.end());
+        odd_views.insert(odd_views.begin(), views.begin(), views.begin() + 5);
+
+        auto odd_ranks = dfa.rank_many(odd_views);
+        for (std::size_t i = 0; i < odd_views.size(); ++i) {
+            REQUIRE(odd_ranks[i] == dfa.rank(std::string{odd_views[i]}));
+        }
+    }
+}
+
+TEST_CASE("Rank and unrank without copies") {
+    using namespace dfare::dfa;
+    auto dfa = RankedDFA::from_string("(a+b+c)(0+1)*", 4);
+
+    std::string text = "xxb010yy";
+    REQUIRE(dfa.rank(std::string_view{text}.substr(2, 4)) == dfa.rank(std::string{"b010"}));
+
+    std::string buffer = "<>";
+    buffer.resize(6);
+    dfa.unrank(dfa.rank("c101"), buffer.data() + 2);
+    REQUIRE(buffer == std::string{"<>c101"});
+
+    auto letters = RankedDFA::from_string("a+b+c+d", 1);
+    for (char chr : {'a', 'b', 'c', 'd'}) {
+        REQUIRE(letters.rank(chr) == letters.rank(std::string{chr}));
+        char word;
+        letters.unrank(letters.rank(chr), &word);
+        REQUIRE(word == chr);
+    }
+}
@@ -0,0 +1,74 @@
+/*
+ * author: Adam Budziak
+ */
+
+#include <dfare/regexp/arena_scope.hpp>
+#include <dfare/regexp/RegExp.hpp>
+#include <dfare/regexp/Concat.hpp>
+#include <dfare/regexp/Closure.hpp>
+#include <dfare/regexp/Sum.hpp>
+#include <dfare/regexp/Eps.hpp>
+#include <dfare/regexp/from_string.hpp>
+#include <dfare/dfa/DFA.hpp>
+#include "../catch/catch.hpp"
+
+TEST_CASE("Regexps allocated in an arena") {
+    using namespace dfare::regexp;
+
+    regexp_ptr regex;
+    {
+        arena_scope arena;
+        regex = Concat::create(RegExp::create('x'), Closure::create(RegExp::create('y')));
+
+        REQUIRE(arena.arena().allocated_bytes() > 0);
+        REQUIRE(Empty::create() == Empty{});
+    }
+
+    SECTION("Nodes outlive the scope") {
+        REQUIRE(std::string {*regex} == "xy*");
+        REQUIRE(regex.derivative('x') == Closure::create(RegExp::create('y')));
+    }
+
+    SECTION("Nodes are still hash-consed") {
+        REQUIRE(Concat::create(RegExp::create('x'), Closure::create(RegExp::create('y'))).get() == regex.get());
+    }
+
+    SECTION("Nested scopes") {
+        arena_scope outer;
+        auto a = RegExp::create('q');
+        {
+            arena_scope inner;
+            REQUIRE(RegExp::create('q').get() == a.get());
+        }
+        REQUIRE(outer.arena().allocated_bytes() > 0);
+    }
+
+    SECTION("Nodes detached from the arena") {
+        std::vector<regexp_ptr> detached;
+        {
+            arena_scope arena;
+            detached = {Sum::create(RegExp::create('u'), Closure::create(RegExp::create('v'))), regex};
+        }
+        REQUIRE(detail::in_arena(detached[0]));
+        detach_from_arenas(detached);
+        REQUIRE(!detail::in_arena(detached[0]));
+        REQUIRE(!detail::in_arena(detached[1]));
+        REQUIRE(std::string {*detached[1]} == "xy*");
+
+        // the copies are found by the hash-consing instead of the originals
+        REQUIRE(Sum::create(RegExp::create('u'), Closure::create(RegExp::create('v'))).get() == detached[0].get());
+        REQUIRE(Concat::create(RegExp::create('x'), Closure::create(RegExp::create('y'))).get() == detached[1].get());
+    }
+}
+
+TEST_CASE("DFA built in an arena") {
+    using namespace dfare;
+    auto dfa = dfa::DFA::from_regex(regexp::from_string("a(b+c)*d"));
+
+    REQUIRE(dfa.accepts("abcbd"));
+    REQUIRE(!dfa.accepts("abcb"));
+    // the states don't keep the arenas of the build alive
+    for (const auto& state : dfa.states) {
+        REQUIRE(!regexp::detail::in_arena(state));
+    }
+}
@@ -2,6 +2,8 @@
  * author: Adam Budziak
  */
 
+#include <string>
+
 #include <dfare/regexp/RegExp.hpp>
 #include <dfare/regexp/Sum.hpp>
 #include <dfare/regexp/Eps.hpp>
@@ -58,3 +60,34 @@ TEST_CASE("Closure equivalency") {
     REQUIRE(Closure::create(eps).equivalent(eps));
     REQUIRE(Closure::create(empty).equivalent(eps));
 }
+
+TEST_CASE("Hash-consed regexps") {
+    auto a = RegExp::create('a');
+    auto b = RegExp::create('b');
+    auto c = RegExp::create('c');
+
+    SECTION("Equal regexps are the same node") {
+        REQUIRE(RegExp::create('a').get() == a.get());
+        REQUIRE(Empty::create().get() == Empty::create().get());
+        REQUIRE(Eps::create().get() == Eps::create().get());
+        REQUIRE(Concat::create(a, Closure::create(b)).get() == Concat::create(a, Closure::create(b)).get());
+        REQUIRE(Concat::create(a, b).get() != Concat::create(b, a).get());
+        REQUIRE(Concat::create(a, b)->hash() == Concat::create(a, b)->hash());
+    }
+
+    SECTION("Sums are canonical") {
+        auto abc = Sum::create(a, Sum::create(b, c));
+        REQUIRE(Sum::create(Sum::create(c, b), a).get() == abc.get());
+        REQUIRE(Sum::create(b, Sum::create(a, Sum::create(c, a))).get() == abc.get());
+        REQUIRE(Sum::create(abc, Empty::create()).get() == abc.get());
+        REQUIRE(std::string {*Sum::create(c, Sum::create(b, a))} == "(a+(b+c))");
+    }
+
+    SECTION("Total order") {
+        REQUIRE(a->compare(*b) < 0);
+        REQUIRE(b->compare(*a) > 0);
+        REQUIRE(a->compare(*RegExp::create('a')) == 0);
+        REQUIRE(Empty::create()->compare(*Eps::create()) < 0);
+        REQUIRE(Concat::create(a, b)->compare(*Concat::create(a, c)) < 0);
+    }
+}
@@ -86,3 +86,27 @@ TEST_CASE("Test DFA accepting regexps") {
         REQUIRE(!dfa.accepts("adb"));
     }
 }
+
+TEST_CASE("Compiled DFA") {
+    using namespace dfare::dfa;
+    using namespace dfare::regexp;
+    auto dfa = DFA::from_regex(from_string("a(b+c)*d"));
+
+    SECTION("Bytes with the same transitions share a class") {
+        REQUIRE(dfa.byte_class('b') == dfa.byte_class('c'));
+        REQUIRE(dfa.byte_class('a') != dfa.byte_class('b'));
+        REQUIRE(dfa.byte_class('d') != dfa.byte_class('b'));
+        REQUIRE(dfa.byte_class('e') == dfa.byte_class('\xff'));
+        REQUIRE(dfa.classes_count() == 4);
+    }
+
+    SECTION("Transitions outside of the alphabet lead to the dead state") {
+        REQUIRE(dfa.get_transition(0, 'e') == dfa.dead_state());
+        REQUIRE(!dfa.has_transition(0, 'e'));
+        REQUIRE(dfa.has_transition(0, 'a'));
+        REQUIRE(dfa.get_transition(dfa.dead_state(), 'a') == dfa.dead_state());
+        REQUIRE(dfa.run("ab\xff") == dfa.dead_state());
+        REQUIRE(!dfa.accepts("ab\xff" "d"));
+        REQUIRE(dfa.accepts("abd"));
+    }
+}
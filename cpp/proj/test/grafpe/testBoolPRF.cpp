@@ -4,6 +4,7 @@
 
 #include <grafpe/aes/openssl/AesCtr128PRNG.hpp>
 #include <grafpe/prf/RangeBoolPRF.hpp>
+#include <grafpe/prf/LazyBoolPRF.hpp>
 #include <grafpe/common/print_utils.hpp>
 #include <pur/logger/Logger.hpp>
 #include "../catch/catch.hpp"
@@ -41,3 +42,36 @@ TEST_CASE("RangeBoolPRF is just like frozen PRNG") {
         }
     }
 }
+
+TEST_CASE("LazyBoolPRF memory is bounded by its cache") {
+    using namespace grafpe;
+
+    using prng_t = aes::openssl::AesCtr128PRNG;
+    using prf_t = LazyBoolPRF<prng_t, std::size_t>;
+
+    const auto seed = array_from_string<prng_t::key_type>("0000111122223333");
+
+    auto prf = prf_t{seed, 16};
+    auto uncached = prf_t{seed, 1};
+
+    REQUIRE(prf.cache_capacity() == 16);
+
+    std::vector<bool> coins;
+    for (std::size_t i = 0; i < 64; ++i) {
+        coins.push_back(prf(i));
+        REQUIRE(coins.back() == uncached(i));
+    }
+
+    SECTION("Evicted values are recomputed consistently") {
+        for (std::size_t i = 0; i < 64; ++i) {
+            REQUIRE(prf(i) == coins[i]);
+        }
+        REQUIRE(prf.cache_stats().evictions > 0);
+    }
+
+    SECTION("Repeated queries hit the cache") {
+        const auto hits = prf.cache_stats().hits;
+        REQUIRE(prf(63) == coins[63]);
+        REQUIRE(prf.cache_stats().hits == hits + 1);
+    }
+}
@@ -54,4 +54,8 @@ TEST_CASE("Basic test of CSDC") {
     for(std::size_t i = 0; i < extended_domain.size(); ++i) {
         REQUIRE(extended_domain[i] == i + 100);
     }
+
+    for (point_t x = 0; x < 200; ++x) {
+        REQUIRE(csdc.decrypt(range_200_crypter, csdc.encrypt(range_200_crypter, x, tweak_t{7}), tweak_t{7}) == x);
+    }
 }
@@ -0,0 +1,77 @@
+/*
+ * author: Adam Budziak
+ */
+
+#include <grafpe/crypt/Codebook.hpp>
+#include <grafpe/crypt/ScalarGrafpe.hpp>
+#include <grafpe/crypt/Targeted.hpp>
+#include <grafpe/domain/CycleWalker.hpp>
+#include "../catch/catch.hpp"
+
+TEST_CASE("Codebook is equivalent to the wrapped crypter") {
+    using namespace grafpe;
+    using Crypter = crypter::ScalarGrafpe<aes::openssl::AesCtr128PRNG>;
+
+    const auto key = array_from_string<Crypter::key_type>("0000111122223333");
+    const auto  iv = array_from_string<Crypter::iv_type>("3333222211110000");
+
+    const point_t N = 3000;
+
+    auto alice = Crypter{key, iv, N, 4, 16};
+    auto codebook = crypter::Codebook{alice, N};
+
+    for (point_t x = 0; x < N; x += 7) {
+        REQUIRE(codebook.encrypt(x) == alice.encrypt(x));
+        REQUIRE(codebook.encrypt(x, tweak_t{42}) == alice.encrypt(x, tweak_t{42}));
+        REQUIRE(codebook.decrypt(codebook.encrypt(x)) == x);
+    }
+
+    auto stats = codebook.cache_stats();
+    REQUIRE(stats.misses == 2);
+    REQUIRE(stats.hits == stats.lookups() - 2);
+
+    REQUIRE_THROWS_AS(codebook.encrypt(N), std::out_of_range);
+
+    SECTION("The memory budget bounds the number of cached tweaks") {
+        const auto budget = 2 * N * sizeof(point_t);
+        auto bounded = crypter::Codebook{alice, N, budget};
+
+        REQUIRE(bounded.encrypt(5, tweak_t{1}) == alice.encrypt(5, tweak_t{1}));
+        REQUIRE(bounded.encrypt(5, tweak_t{2}) == alice.encrypt(5, tweak_t{2}));
+        REQUIRE(bounded.encrypt(5, tweak_t{1}) == alice.encrypt(5, tweak_t{1}));
+        REQUIRE(bounded.cache_stats().evictions == 2);
+
+        REQUIRE_THROWS_AS(crypter::Codebook(alice, N, budget - 1), std::invalid_argument);
+    }
+
+    SECTION("Domains larger than the codebook are rejected") {
+        REQUIRE_THROWS_AS(crypter::Codebook(alice, N / 2), std::invalid_argument);
+
+        // the walk lands anywhere below N, but the codebook covers only the first half
+        auto walked = crypter::Targeted{domain::targeting::CycleWalker<Crypter>{
+                [](const point_t& x) { return x % 2 == 0; }}, alice};
+        auto small = crypter::Codebook{walked, N / 2};
+        REQUIRE_THROWS_AS(small.encrypt(0), std::logic_error);
+    }
+}
+
+TEST_CASE("Codebook of a targeted crypter") {
+    using namespace grafpe;
+    using Crypter = crypter::ScalarGrafpe<aes::openssl::AesCtr128PRNG>;
+    using CycleWalker = domain::targeting::CycleWalker<Crypter>;
+
+    const auto key = array_from_string<Crypter::key_type>("0000111122223333");
+    const auto  iv = array_from_string<Crypter::iv_type>("3333222211110000");
+
+    const point_t N = 1000;
+    const auto in_domain = [](const point_t& x) { return !(x % 5); };
+
+    auto targeted = crypter::Targeted{CycleWalker{in_domain}, Crypter{key, iv, N, 4, 4}};
+    auto codebook = crypter::Codebook{targeted, N, in_domain};
+
+    for (point_t x = 0; x < N; x += 5) {
+        REQUIRE(codebook.encrypt(x) == targeted.encrypt(x));
+        REQUIRE(codebook.decrypt(codebook.encrypt(x)) == x);
+    }
+    REQUIRE_THROWS_AS(codebook.encrypt(1), std::out_of_range);
+}
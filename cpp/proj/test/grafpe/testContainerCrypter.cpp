@@ -36,3 +36,39 @@ TEST_CASE("Basic test of container crypter") {
         "Pizza", "Burger", "Ramen", "Pasibus", "Spaghetti", "Burrito"
     });
 }
+
+TEST_CASE("Container crypter index") {
+    using namespace grafpe;
+    using namespace aes::openssl;
+    using Grafpe = crypter::ScalarGrafpe<AesCtr128PRNG>;
+
+    const auto key = hex_to_array<AesCtr128::key_type>("6306296DB6C6FE5E534AC6742EE04713");
+    const auto  iv = hex_to_array<AesCtr128::iv_type>("734971FF22AFD5185159CB2CDD2D6509");
+
+    SECTION("Large dictionaries") {
+        std::vector<std::string> codes;
+        for (int i = 0; i < 100000; ++i) {
+            codes.push_back("P-" + std::to_string(i * 1024));
+        }
+        rte::Container crypter {codes, Grafpe{key, iv, codes.size(), 4, 100}};
+
+        for (std::size_t i = 0; i < codes.size(); i += 97) {
+            REQUIRE(crypter.cast(codes[i]) == i);
+            REQUIRE(crypter.decrypt(crypter.encrypt(codes[i])) == codes[i]);
+        }
+        REQUIRE(crypter.find("P-1024") == crypter.container().begin() + 1);
+        REQUIRE(crypter.find("P-1") == crypter.container().end());
+    }
+
+    SECTION("Missing values are reported") {
+        auto numbers = std::vector<uint64_t>{4096, 0, 8192, 1, 4096};
+        rte::Container crypter {numbers, Grafpe{key, iv, numbers.size(), 4, 100}};
+
+        REQUIRE(crypter.contains(8192));
+        REQUIRE(!crypter.contains(2));
+        REQUIRE_THROWS_AS(crypter.encrypt(2), std::out_of_range);
+        // the first occurrence is used for the repeated values
+        REQUIRE(crypter.cast(4096) == 0);
+        REQUIRE(crypter.cast(1) == 3);
+    }
+}
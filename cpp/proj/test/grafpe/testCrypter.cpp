@@ -11,7 +11,9 @@
 #include <grafpe/aes/openssl/AesCtr128PRNG.hpp>
 #include <grafpe/crypt/Grafpe.hpp>
 #include <grafpe/common/print_utils.hpp>
+#include <grafpe/crypt/RadixGrafpe.hpp>
 #include <grafpe/crypt/ScalarGrafpe.hpp>
+#include <grafpe/crypt/simd.hpp>
 
 
 TEST_CASE("Grafpe is deterministic") {
@@ -256,3 +258,138 @@ TEST_CASE("Grafpe with tweaks") {
         REQUIRE(alice.decrypt(alice.encrypt(plaintext, tweak_t{0})) == plaintext);
     }
 }
+
+TEST_CASE("ScalarGrafpe caches walks per tweak") {
+    using namespace grafpe;
+    using namespace grafpe::aes;
+    using Crypter = crypter::ScalarGrafpe<openssl::AesCtr128PRNG>;
+
+    const auto key = array_from_string<Crypter::key_type>("aaaabbbbccccdddd");
+    const auto  iv = array_from_string<Crypter::iv_type>("ddddccccbbbbaaaa");
+
+    const point_t N = 1000;
+    const std::size_t D = 4, walk_length = 64;
+
+    auto cached = Crypter{key, iv, N, D, walk_length, 4};
+    auto uncached = Crypter{key, iv, N, D, walk_length, 0};
+
+    SECTION("Cached walks give the same results") {
+        for (uint64_t tweak = 0; tweak < 8; ++tweak) {
+            for (point_t x = 0; x < N; x += 37) {
+                auto y = cached.encrypt(x, tweak_t{tweak});
+                REQUIRE(y == uncached.encrypt(x, tweak_t{tweak}));
+                REQUIRE(cached.decrypt(y, tweak_t{tweak}) == x);
+                REQUIRE(uncached.decrypt(y, tweak_t{tweak}) == x);
+            }
+        }
+        REQUIRE(cached.encrypt(7, tweak_t{3}) == 343);
+    }
+
+    SECTION("Hit rate of the walk cache") {
+        for (point_t x = 0; x < 10; ++x) {
+            REQUIRE(cached.encrypt(x, tweak_t{5}) < N);
+        }
+        auto stats = cached.walk_cache_stats();
+        REQUIRE(stats.misses == 1);
+        REQUIRE(stats.hits == 9);
+
+        auto copy = cached;
+        REQUIRE(copy.decrypt(1, tweak_t{5}) < N);
+        REQUIRE(cached.walk_cache_stats().hits == 10);
+        REQUIRE(uncached.walk_cache_stats().hits == 0);
+    }
+}
+
+TEST_CASE("ScalarGrafpe batch encryption") {
+    using namespace grafpe;
+    using namespace grafpe::aes;
+    using Crypter = crypter::ScalarGrafpe<openssl::AesCtr128PRNG>;
+
+    const auto key = array_from_string<Crypter::key_type>("0000111122223333");
+    const auto  iv = array_from_string<Crypter::iv_type>("3333222211110000");
+
+    const point_t N = 1000;
+    const std::size_t D = 4, walk_length = 64;
+
+    auto crypter = Crypter{key, iv, N, D, walk_length};
+
+    // not a multiple of any vector width, so that the remainders are walked as well
+    std::vector<point_t> values;
+    for (point_t x = 0; x < 2 * N + 13; ++x) {
+        values.push_back(x);
+    }
+
+    for (auto instruction_set : simd::all_supported()) {
+        SECTION(std::string{"Batches are equivalent to single values: "} + simd::to_string(instruction_set)) {
+            for (uint64_t tweak : {0, 1, 77}) {
+                std::vector<point_t> ciphers(values.size());
+                crypter.encrypt_batch(values.data(), ciphers.data(), values.size(), tweak_t{tweak}, instruction_set);
+
+                for (std::size_t i = 0; i < values.size(); ++i) {
+                    REQUIRE(ciphers[i] == crypter.encrypt(values[i], tweak_t{tweak}));
+                }
+
+                crypter.decrypt_batch(ciphers.data(), ciphers.data(), ciphers.size(), tweak_t{tweak}, instruction_set);
+                for (std::size_t i = 0; i < values.size(); ++i) {
+                    REQUIRE(ciphers[i] == values[i] % N);
+                }
+            }
+        }
+    }
+
+    SECTION("Default instruction set") {
+        REQUIRE(simd::is_supported(simd::isa::scalar));
+        REQUIRE(crypter.decrypt_batch(crypter.encrypt_batch({1, 2, 3})) == std::vector<point_t>{1, 2, 3});
+    }
+}
+
+
+TEST_CASE("RadixGrafpe") {
+    using namespace grafpe;
+    using namespace aes::openssl;
+    using Crypter = crypter::RadixGrafpe<AesCtr128PRNG>;
+
+    const auto key = array_from_string<Crypter::key_type>("0123012301233210");
+    const auto  iv = array_from_string<Crypter::iv_type>("3210321032103210");
+
+    SECTION("The digits cover the domain tightly") {
+        REQUIRE(Crypter{key, iv, 1000, 4, 4, 16}.base() == 10);
+        REQUIRE(Crypter{key, iv, 1000, 4, 4, 16}.digits() == 3);
+        REQUIRE(Crypter{key, iv, 1001, 4, 4, 16}.base() == 11);
+        REQUIRE(Crypter{key, iv, 200, 4, 4, 256}.digits() == 1);
+
+        auto huge = Crypter{key, iv, UINT64_MAX, 4, 4};
+        REQUIRE(huge.digits() == 4);
+        REQUIRE(huge.base() == 65536);
+
+        REQUIRE_THROWS_AS((Crypter{key, iv, 1, 4, 4}), std::invalid_argument);
+    }
+
+    SECTION("Encryption permutes the domain") {
+        for (uint64_t N : {1000, 1013}) {
+            auto crypter = Crypter{key, iv, N, 4, 8, 16};
+
+            std::unordered_set<uint64_t> images;
+            for (uint64_t x = 0; x < N; ++x) {
+                auto y = crypter.encrypt(x, tweak_t{5});
+                REQUIRE(y < N);
+                REQUIRE(crypter.decrypt(y, tweak_t{5}) == x);
+                images.insert(y);
+            }
+            REQUIRE(images.size() == N);
+            REQUIRE_THROWS_AS(crypter.encrypt(N), std::out_of_range);
+        }
+    }
+
+    SECTION("Domains far beyond a single graph") {
+        const uint64_t N = 95'428'956'661'682'176;  // 26^12
+        auto crypter = Crypter{key, iv, N, 4, 8};
+        REQUIRE(crypter.base() == 17576);  // 26^3, no walking at all
+
+        for (uint64_t x = 0; x < N; x += N / 97) {
+            auto y = crypter.encrypt(x);
+            REQUIRE(y < N);
+            REQUIRE(crypter.decrypt(y) == x);
+        }
+    }
+}
@@ -0,0 +1,110 @@
+/*
+ * author: Adam Budziak
+ */
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <grafpe/aes/openssl/AesCtr128PRNG.hpp>
+#include <grafpe/common/print_utils.hpp>
+#include <grafpe/crypt/ScalarGrafpe.hpp>
+#include <grafpe/rte/Container.hpp>
+#include <grafpe/rte/Csv.hpp>
+#include <grafpe/rte/DFA.hpp>
+#include "../catch/catch.hpp"
+
+namespace {
+
+std::string run_stream(const grafpe::rte::CsvStream& stream, const std::string& input, bool forward,
+                       bool header = false) {
+    std::FILE* in = std::tmpfile();
+    std::FILE* out = std::tmpfile();
+    std::fwrite(input.data(), 1, input.size(), in);
+    std::rewind(in);
+
+    if (forward) {
+        stream.encrypt(in, out, grafpe::tweak_t{9}, header);
+    } else {
+        stream.decrypt(in, out, grafpe::tweak_t{9}, header);
+    }
+
+    std::string result(static_cast<std::size_t>(std::ftell(out)), '\0');
+    std::rewind(out);
+    REQUIRE(std::fread(result.data(), 1, result.size(), out) == result.size());
+    std::fclose(in);
+    std::fclose(out);
+    return result;
+}
+
+}  // namespace
+
+TEST_CASE("Streaming CSV encryption") {
+    using namespace grafpe;
+    using Crypter = crypter::ScalarGrafpe<aes::openssl::AesCtr128PRNG>;
+
+    const auto key = hex_to_array<Crypter::key_type>("912C314E129436D3B23C506C424A32B6");
+    const auto  iv = hex_to_array<Crypter::iv_type>("CE438C4A1E3E92B707821B9E0599F62A");
+
+    const std::vector<std::string> cities {"Wroclaw", "Krakow", "Gdansk", "Poznan", "Lodz"};
+    auto codes = dfare::dfa::RankedDFA::from_string("(a+b+c)*", 4);
+
+    auto make_columns = [&] {
+        return rte::CsvStream::columns_type {
+            rte::make_field(Crypter{key, iv, 1000, 4, 16}),
+            nullptr,
+            rte::make_field(rte::DFA{codes, Crypter{key, iv, codes.max_rank, 4, 16}}),
+            rte::make_field(rte::Container{cities, Crypter{key, iv, cities.size(), 4, 16}})
+        };
+    };
+
+    std::string input = "id,comment,code,city,extra\n";
+    for (int row = 0; row < 2000; ++row) {
+        input += std::to_string(row % 1000) + ",row " + std::to_string(row) + ','
+               + codes.unrank(static_cast<std::size_t>(row) % codes.max_rank) + ','
+               + cities[row % cities.size()] + (row % 3 ? ",x" : "") + (row % 7 ? "\n" : "\r\n");
+        if (row % 500 == 0) { input += '\n'; }
+    }
+    input += "7,last,abca,Lodz";
+
+    // tiny chunks, so the records are cut between the reads, and more threads than slices
+    for (std::size_t chunk : {std::size_t{16}, std::size_t{1000}, rte::CsvStream::DEFAULT_CHUNK_SIZE}) {
+        for (std::size_t threads : {1, 3}) {
+            rte::CsvStream stream{make_columns(), ',', threads, chunk};
+            auto encrypted = run_stream(stream, input, true, true);
+
+            REQUIRE(encrypted.substr(0, encrypted.find('\n')) == "id,comment,code,city,extra");
+            REQUIRE(encrypted != input);
+            REQUIRE(run_stream(stream, encrypted, false, true) == input);
+
+            std::string expected;
+            stream.transform(std::string_view{input}.substr(input.find('\n') + 1), expected, tweak_t{9}, true);
+            REQUIRE(encrypted.substr(encrypted.find('\n') + 1) == expected);
+        }
+    }
+
+    SECTION("Fields are encrypted with their crypters") {
+        rte::CsvStream stream{make_columns()};
+        std::string out;
+        stream.transform("17,hello,abca,Krakow", out, tweak_t{9}, true);
+
+        auto dfa = rte::DFA{codes, Crypter{key, iv, codes.max_rank, 4, 16}};
+        auto container = rte::Container{cities, Crypter{key, iv, cities.size(), 4, 16}};
+        REQUIRE(out == std::to_string(Crypter{key, iv, 1000, 4, 16}.encrypt(17, tweak_t{9})) + ",hello,"
+                       + dfa.encrypt("abca", tweak_t{9}) + ',' + container.encrypt("Krakow", tweak_t{9}));
+    }
+
+    SECTION("Invalid fields") {
+        rte::CsvStream stream{make_columns(), ',', 2, 64};
+        REQUIRE_THROWS_AS(run_stream(stream, "12,a,abca,Lodz\nx12,a,abca,Lodz\n", true), std::invalid_argument);
+        REQUIRE_THROWS_AS(run_stream(stream, "12,a,abca,Paris\n", true), std::out_of_range);
+        // ScalarGrafpe would reduce them modulo 1000 and the originals would be lost
+        REQUIRE_THROWS_AS(run_stream(stream, "1000,a,abca,Lodz\n", true), std::out_of_range);
+        REQUIRE_THROWS_AS(run_stream(stream, "5000,a,abca,Lodz\n", false), std::out_of_range);
+        // words of another length or outside of the language would be ranked into someone else's word
+        REQUIRE_THROWS_AS(run_stream(stream, "12,a,abcab,Lodz\n", true), std::out_of_range);
+        REQUIRE_THROWS_AS(run_stream(stream, "12,a,ab,Lodz\n", true), std::out_of_range);
+        REQUIRE_THROWS_AS(run_stream(stream, "12,a,abcd,Lodz\n", true), std::out_of_range);
+        REQUIRE_THROWS_AS((rte::CsvStream{{}, '\n'}), std::invalid_argument);
+    }
+}
@@ -54,4 +54,13 @@ TEST_CASE("CycleSlicer basic test") {
             }
         }
     }
+
+    SECTION("Keeping the type of the inclusion function doesn't change the permutation") {
+        domain::targeting::CycleSlicer<Crypter> erased{{key, iv}, incl_func, 1000};
+        auto typed = domain::targeting::make_cycle_slicer<Crypter>({key, iv}, incl_func, 1000);
+        for (point_t x = 0; x < N; ++x) {
+            REQUIRE(typed.encrypt(alice, x, tweak_t{3}) == erased.encrypt(alice, x, tweak_t{3}));
+            REQUIRE(typed.decrypt(alice, typed.encrypt(alice, x, tweak_t{3}), tweak_t{3}) == x);
+        }
+    }
 }
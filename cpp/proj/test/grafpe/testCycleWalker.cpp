@@ -5,7 +5,9 @@
 #include <grafpe/common/print_utils.hpp>
 #include <grafpe/crypt/Grafpe.hpp>
 #include <grafpe/domain/CycleWalker.hpp>
+#include <grafpe/crypt/Targeted.hpp>
 #include <grafpe/crypt/ScalarGrafpe.hpp>
+#include <grafpe/crypt/Static.hpp>
 #include "../catch/catch.hpp"
 
 
@@ -48,3 +50,99 @@ TEST_CASE("CycleWalker basic test") {
         REQUIRE(is_permutation(ciphers));
     }
 }
+
+TEST_CASE("CycleWalker batches with lane refilling") {
+    using namespace grafpe;
+    using Crypter = crypter::ScalarGrafpe<aes::openssl::AesCtr128PRNG>;
+    using CycleWalker = grafpe::domain::targeting::CycleWalker<Crypter>;
+
+    auto key = array_from_string<Crypter::key_type>("0000111122223333");
+    auto  iv = array_from_string<Crypter::iv_type>("3333222211110000");
+
+    const point_t N = 1000;
+    auto alice = Crypter{key, iv, N, 4, 16};
+
+    CycleWalker walker{[](const point_t& num) { return !(num % 7); }};
+    auto targeted = crypter::Targeted{walker, alice};
+
+    std::vector<point_t> inputs;
+    for (point_t num = 0; num < N; num += 7) {
+        inputs.push_back(num);
+    }
+
+    SECTION("Batches are equivalent to single values") {
+        for (std::size_t lanes : {1, 3, 16, 1000}) {
+            std::vector<point_t> ciphers(inputs.size());
+            walker.encrypt_batch(alice, inputs.data(), ciphers.data(), inputs.size(), tweak_t{3}, lanes);
+            for (std::size_t i = 0; i < inputs.size(); ++i) {
+                REQUIRE(ciphers[i] == walker.encrypt(alice, inputs[i], tweak_t{3}));
+            }
+
+            walker.decrypt_batch(alice, ciphers.data(), ciphers.data(), ciphers.size(), tweak_t{3}, lanes);
+            REQUIRE(ciphers == inputs);
+        }
+    }
+
+    SECTION("Targeted crypter uses the batch API") {
+        auto ciphers = targeted.encrypt_batch(inputs);
+        for (std::size_t i = 0; i < inputs.size(); ++i) {
+            REQUIRE(ciphers[i] == targeted.encrypt(inputs[i]));
+        }
+        REQUIRE(targeted.decrypt_batch(ciphers) == inputs);
+        REQUIRE(targeted.encrypt_batch(std::vector<point_t>{}).empty());
+    }
+}
+
+TEST_CASE("Static composition matches the virtual one") {
+    using namespace grafpe;
+    using Crypter = crypter::ScalarGrafpe<aes::openssl::AesCtr128PRNG>;
+
+    auto key = array_from_string<Crypter::key_type>("0000111122223333");
+    auto  iv = array_from_string<Crypter::iv_type>("3333222211110000");
+
+    const point_t N = 1000;
+    auto alice = Crypter{key, iv, N, 4, 16};
+
+    auto virtual_stack = crypter::Targeted{
+        domain::targeting::CycleWalker<Crypter>{[](const point_t& num) { return !(num % 7); }}, alice};
+
+    auto cast = crypter::StaticCastCrypter{alice,
+                                           [](uint32_t value) { return point_t{value}; },
+                                           [](point_t value) { return static_cast<uint32_t>(value); }};
+    auto static_stack = crypter::StaticTargeted{
+        domain::targeting::make_cycle_walker<decltype(cast)>([](const uint32_t& num) { return !(num % 7); }),
+        cast};
+    static_assert(std::is_same_v<decltype(static_stack)::value_type, uint32_t>);
+
+    std::vector<uint32_t> inputs;
+    for (uint32_t num = 0; num < N; num += 7) {
+        inputs.push_back(num);
+    }
+
+    SECTION("Single values") {
+        for (auto num : inputs) {
+            auto cipher = static_stack.encrypt(num, tweak_t{5});
+            REQUIRE(cipher == virtual_stack.encrypt(num, tweak_t{5}));
+            REQUIRE(static_stack.decrypt(cipher, tweak_t{5}) == num);
+        }
+    }
+
+    SECTION("Batches") {
+        std::vector<uint32_t> ciphers(inputs.size());
+        static_stack.encrypt_batch(inputs.data(), ciphers.data(), inputs.size(), tweak_t{5});
+        for (std::size_t i = 0; i < inputs.size(); ++i) {
+            REQUIRE(ciphers[i] == static_stack.encrypt(inputs[i], tweak_t{5}));
+        }
+        static_stack.decrypt_batch(ciphers.data(), ciphers.data(), ciphers.size(), tweak_t{5});
+        REQUIRE(ciphers == inputs);
+    }
+
+    SECTION("Behind the virtual interface") {
+        auto dynamic = crypter::Dynamic{static_stack};
+        const crypter::Base<uint32_t>& base = dynamic;
+        for (auto num : inputs) {
+            REQUIRE(base.encrypt(num) == static_stack.encrypt(num));
+            REQUIRE(base.decrypt(base.encrypt(num)) == num);
+        }
+    }
+}
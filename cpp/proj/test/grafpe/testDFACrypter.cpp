@@ -2,11 +2,13 @@
  * author: Adam Budziak
  */
 
+#include <filesystem>
 #include <string>
 
 #include <grafpe/common/print_utils.hpp>
 #include <grafpe/rte/DFA.hpp>
 #include <grafpe/aes/openssl/AesCtr128PRNG.hpp>
+#include <grafpe/crypt/RadixGrafpe.hpp>
 #include <grafpe/crypt/ScalarGrafpe.hpp>
 #include "../catch/catch.hpp"
 
@@ -57,4 +59,77 @@ TEST_CASE("Basic tests of encryption/decryption of DFA") {
             REQUIRE(crypter.encrypt(dfa.unrank(i)) == results[i]);
         }
     }
+    SECTION("DFA mapped from the cache encrypts the same") {
+        const auto regexp = "Nie____+Rusz___+Andziu_+tego___+kwiatka+roza___+kole___";
+        const auto path = (std::filesystem::temp_directory_path() / "grafpe_test_dfa_crypter.dfa").string();
+        std::filesystem::remove(path);
+
+        auto built = dfare::dfa::RankedDFA::from_string(regexp, 7);
+        dfare::dfa::RankedDFA::from_string_cached(regexp, 7, path);
+        auto loaded = dfare::dfa::RankedDFA::from_string_cached(regexp, 7, path);
+
+        auto crypter = rte::DFA{built, Crypter{key, iv, built.max_rank, 4, 4}};
+        auto cached_crypter = rte::DFA{loaded, Crypter{key, iv, loaded.max_rank, 4, 4}};
+        for (size_t i = 0; i < built.max_rank; ++i) {
+            auto word = built.unrank(i);
+            REQUIRE(cached_crypter.encrypt(word) == crypter.encrypt(word));
+            REQUIRE(cached_crypter.decrypt(cached_crypter.encrypt(word)) == word);
+        }
+        std::filesystem::remove(path);
+    }
+}
+
+
+TEST_CASE("DFA encryption of large formats") {
+    using namespace grafpe;
+    using Crypter = crypter::RadixGrafpe<aes::openssl::AesCtr128PRNG>;
+
+    const auto key = array_from_string<Crypter::key_type>("aaaabbbbccccdddd");
+    const auto  iv = array_from_string<Crypter::iv_type>("ddddccccbbbbaaaa");
+
+    // 12-letter names followed by a 2-digit number, far too many for a single graph
+    std::string format = "(A+B+C+D+E+F+G+H+I+J+K+L+M+N+O+P+Q+R+S+T+U+V+W+X+Y+Z)";
+    for (int i = 1; i < 12; ++i) {
+        format += "(a+b+c+d+e+f+g+h+i+j+k+l+m+n+o+p+q+r+s+t+u+v+w+x+y+z)";
+    }
+    for (int i = 0; i < 2; ++i) {
+        format += "(0+1+2+3+4+5+6+7+8+9)";
+    }
+    auto ranked = dfare::dfa::RankedDFA::from_string(format, 14);
+    REQUIRE(ranked.max_rank == 9'542'895'666'168'217'600ull);
+
+    auto crypter = rte::DFA{ranked, Crypter{key, iv, ranked.max_rank, 4, 8}};
+    for (auto& input : {"Abcdefghijkl00", "Zzzzzzzzzzzz99", "Grafpeisfast20"}) {
+        auto encrypted = crypter.encrypt(input);
+        REQUIRE(ranked.accepts(encrypted));
+        REQUIRE(encrypted != input);
+        REQUIRE(crypter.decrypt(encrypted) == input);
+    }
+}
+
+TEST_CASE("DFA encryption into a caller's buffer") {
+    using namespace grafpe;
+    using Crypter = crypter::ScalarGrafpe<aes::openssl::AesCtr128PRNG>;
+
+    const auto key = array_from_string<Crypter::key_type>("aaaabbbbccccdddd");
+    const auto  iv = array_from_string<Crypter::iv_type>("ddddccccbbbbaaaa");
+
+    auto ranked = dfare::dfa::RankedDFA::from_string("(a+b+c)*", 5);
+    auto crypter = rte::DFA{ranked, Crypter{key, iv, ranked.max_rank, 4, 4}};
+
+    std::string record = "abcab,ccccc";
+    std::string encrypted = "id=";
+    crypter.encrypt_into(std::string_view{record}.substr(0, 5), encrypted, tweak_t{7});
+    encrypted += ',';
+    crypter.encrypt_into(std::string_view{record}.substr(6), encrypted, tweak_t{7});
+    REQUIRE(encrypted == "id=" + crypter.encrypt("abcab", tweak_t{7}) + ',' + crypter.encrypt("ccccc", tweak_t{7}));
+
+    std::string decrypted;
+    crypter.decrypt_into(std::string_view{encrypted}.substr(3, 5), decrypted, tweak_t{7});
+    REQUIRE(decrypted == "abcab");
+
+    std::vector<std::string> words {"abcab", "aaaaa", "bbbbb"};
+    auto ciphers = crypter.encrypt_batch(words, tweak_t{7});
+    REQUIRE(ciphers[0] == crypter.encrypt("abcab", tweak_t{7}));
+    REQUIRE(crypter.decrypt_batch(ciphers, tweak_t{7}) == words);
 }
@@ -0,0 +1,75 @@
+/*
+ * author: Adam Budziak
+ */
+
+#include <grafpe/domain/rounds.hpp>
+#include <grafpe/domain/CycleSlicer.hpp>
+#include <grafpe/domain/ReverseCycleWalker.hpp>
+#include <grafpe/domain/CSDC.hpp>
+#include <grafpe/crypt/ScalarGrafpe.hpp>
+#include "../catch/catch.hpp"
+
+TEST_CASE("Round counts match the offline tools") {
+    using namespace grafpe::domain;
+
+    SECTION("CycleSlicer") {
+        // values computed with tools/cslicer_rounds.py
+        REQUIRE(cycle_slicer_rounds(30, 6, 0.01) == 607);
+        REQUIRE(cycle_slicer_rounds(1000, 100, 0.000001) == 1184);
+        REQUIRE(cycle_slicer_rounds(200, 100, 0.001) == 1457);
+
+        REQUIRE(cycle_slicer_distance(30, 6, 607) <= 0.01);
+        REQUIRE(cycle_slicer_distance(30, 6, 606) > 0.01);
+    }
+
+    SECTION("ReverseCycleWalker") {
+        // values computed with tools/rcwalker_rounds.py
+        REQUIRE(reverse_cycle_walker_rounds(15, 256, 0.01) == 14249);
+        REQUIRE(reverse_cycle_walker_rounds(100, 200, 0.001) == 10002);
+        REQUIRE(reverse_cycle_walker_rounds(1000, 10000, 0.000001) == 45606);
+
+        REQUIRE(reverse_cycle_walker_distance(100, 200, 10002) <= 0.001);
+        REQUIRE(reverse_cycle_walker_distance(100, 200, 10001) > 0.001);
+    }
+
+    SECTION("Invalid parameters are rejected") {
+        REQUIRE_THROWS_AS(cycle_slicer_rounds(30, 6, 0), std::invalid_argument);
+        REQUIRE_THROWS_AS(cycle_slicer_rounds(30, 6, 1.5), std::invalid_argument);
+        REQUIRE_THROWS_AS(cycle_slicer_rounds(0, 6, 0.1), std::invalid_argument);
+        REQUIRE_THROWS_AS(reverse_cycle_walker_rounds(200, 100, 0.1), std::invalid_argument);
+    }
+}
+
+TEST_CASE("Targeters can be created from the TV threshold") {
+    using namespace grafpe;
+    using Crypter = crypter::ScalarGrafpe<aes::openssl::AesCtr128PRNG>;
+    using domain::targeting::CycleSlicer;
+    using domain::targeting::ReverseCycleWalker;
+
+    const auto key = array_from_string<Crypter::key_type>("0000111122223333");
+    const auto  iv = array_from_string<Crypter::iv_type>("3333222211110000");
+
+    auto slicer = CycleSlicer<Crypter>::from_tv_threshold(
+            {key, iv}, [](point_t l, point_t r) { return !(l % 5) && !(r % 5); },
+            30, 6, 0.01);
+    REQUIRE(slicer.get_rounds_cnt() == domain::cycle_slicer_rounds(30, 6, 0.01));
+
+    auto rcw = ReverseCycleWalker<Crypter>::from_tv_threshold(
+            vec_u8_t{key.begin(), key.end()}, [](point_t x) { return !(x % 17); },
+            15, 256, 0.01);
+    REQUIRE(rcw.get_rounds_cnt() == domain::reverse_cycle_walker_rounds(15, 256, 0.01));
+
+    auto identity = [](const point_t& v, const tweak_t&) { return v; };
+    auto csdc = domain::extension::CSDC<Crypter, aes::openssl::AesCtr128PRNG>::from_tv_threshold(
+            identity, identity,
+            [](point_t p) { return p < 10; }, [](point_t p) { return p < 10; },
+            {key, iv}, 20, 10, 0.001);
+    REQUIRE(csdc.get_rounds_cnt() == domain::cycle_slicer_rounds(20, 10, 0.001));
+
+    SECTION("CycleSlicer built this way is still a permutation") {
+        auto alice = Crypter{key, iv, 30, 4, 4};
+        for (point_t x = 0; x < 30; x += 5) {
+            REQUIRE(slicer.decrypt(alice, slicer.encrypt(alice, x)) == x);
+        }
+    }
+}
@@ -0,0 +1,129 @@
+/*
+ * author: Adam Budziak
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <grafpe/aes/openssl/AesCtr128PRNG.hpp>
+#include <grafpe/common/print_utils.hpp>
+#include <grafpe/graph/GraphBuilder.hpp>
+#include <grafpe/graph/mixing.hpp>
+#include "../catch/catch.hpp"
+
+namespace {
+
+// all the eigenvalues of a dense symmetric matrix (cyclic Jacobi rotations)
+std::vector<double> symmetric_eigenvalues(std::vector<std::vector<double>> a) {
+    const auto n = a.size();
+    for (int sweep = 0; sweep < 100; ++sweep) {
+        double off = 0;
+        for (std::size_t p = 0; p < n; ++p) {
+            for (std::size_t q = p + 1; q < n; ++q) { off += a[p][q] * a[p][q]; }
+        }
+        if (off < 1e-24) { break; }
+
+        for (std::size_t p = 0; p < n; ++p) {
+            for (std::size_t q = p + 1; q < n; ++q) {
+                if (a[p][q] == 0) { continue; }
+                const auto theta = (a[q][q] - a[p][p]) / (2 * a[p][q]);
+                const auto t = (theta >= 0 ? 1.0 : -1.0) / (std::abs(theta) + std::sqrt(theta * theta + 1));
+                const auto c = 1 / std::sqrt(t * t + 1);
+                const auto s = t * c;
+                for (std::size_t k = 0; k < n; ++k) {
+                    const auto kp = a[k][p], kq = a[k][q];
+                    a[k][p] = c * kp - s * kq;
+                    a[k][q] = s * kp + c * kq;
+                }
+                for (std::size_t k = 0; k < n; ++k) {
+                    const auto pk = a[p][k], qk = a[q][k];
+                    a[p][k] = c * pk - s * qk;
+                    a[q][k] = s * pk + c * qk;
+                }
+            }
+        }
+    }
+    std::vector<double> eigenvalues;
+    for (std::size_t i = 0; i < n; ++i) { eigenvalues.push_back(a[i][i]); }
+    return eigenvalues;
+}
+
+}  // namespace
+
+TEST_CASE("Mixing of the walk on the graph") {
+    using namespace grafpe;
+    using prng_t = aes::openssl::AesCtr128PRNG;
+
+    const auto key = hex_to_array<prng_t::key_type>("912C314E129436D3B23C506C424A32B6");
+    const auto  iv = hex_to_array<prng_t::iv_type>("CE438C4A1E3E92B707821B9E0599F62A");
+
+    const uint64_t N = 200;
+    const auto graph = GraphBuilder<prng_t>::create_from_engine({key, iv}).build(N, 4);
+    const auto matrix = TransitionMatrix{graph, 2};
+
+    SECTION("One step matches the walk of the crypters") {
+        // the distribution after a step from x, enumerated directly
+        std::vector<double> start(N, 0.0), step;
+        start[7] = 1.0;
+        matrix.apply(start, step);
+
+        std::vector<double> expected(N, 0.0);
+        for (const auto& permutation : graph.permutations) {
+            expected[permutation[7]] += 0.25;
+            expected[inverse_permutation(permutation)[7]] += 0.25;
+        }
+        for (uint64_t y = 0; y < N; ++y) {
+            REQUIRE(step[y] == Approx(expected[y]));
+        }
+
+        const std::vector<double> uniform(N, 1.0 / N);
+        matrix.apply(uniform, step);
+        for (auto p : step) {
+            REQUIRE(p == Approx(1.0 / N));
+        }
+    }
+
+    SECTION("The distance decreases as the spectral bound says") {
+        std::vector<std::vector<double>> dense(N, std::vector<double>(N, 0.0));
+        for (const auto& permutation : graph.permutations) {
+            for (uint64_t x = 0; x < N; ++x) {
+                dense[x][permutation[x]] += 0.25;
+                dense[permutation[x]][x] += 0.25;
+            }
+        }
+        auto eigenvalues = symmetric_eigenvalues(dense);
+        for (auto& eigenvalue : eigenvalues) { eigenvalue = std::abs(eigenvalue); }
+        std::sort(eigenvalues.begin(), eigenvalues.end());
+        REQUIRE(eigenvalues.back() == Approx(1.0));
+        const auto exact = eigenvalues[N - 2];
+
+        const auto lambda = second_eigenvalue(matrix);
+        REQUIRE(lambda >= exact);
+        REQUIRE(lambda <= exact + 1e-3);
+        REQUIRE(lambda < 1.0);
+
+        const auto distances = total_variation(matrix, 0, 40);
+        REQUIRE(distances.size() == 40);
+        REQUIRE(distances[0] == Approx(1.0 - 4.0 / N));
+        for (std::size_t t = 0; t < distances.size(); ++t) {
+            REQUIRE(distances[t] <= std::sqrt(N) / 2 * std::pow(lambda, t + 1));
+            if (t > 0) {
+                REQUIRE(distances[t] <= distances[t - 1]);
+            }
+        }
+    }
+
+    SECTION("Walk lengths for a target distance") {
+        const auto target = std::pow(2.0, -20);
+        const auto measured = min_walk_length(matrix, {0, 1, 2}, target, 200);
+        REQUIRE(measured > 0);
+        REQUIRE(total_variation(matrix, 1, measured).back() <= target);
+        REQUIRE(min_walk_length(matrix, {0}, target, 200) <= measured);
+
+        const auto bound = spectral_walk_length(N, second_eigenvalue(matrix), target);
+        REQUIRE(bound >= measured);
+        REQUIRE(spectral_walk_length(N, 0.5, 1.0) == 3);
+        REQUIRE_THROWS_AS(spectral_walk_length(N, 1.0, target), std::domain_error);
+    }
+}
@@ -4,6 +4,7 @@
 
 #include <grafpe/crypt/Cast.hpp>
 #include <grafpe/crypt/Grafpe.hpp>
+#include <grafpe/rte/Characters.hpp>
 
 #include "../catch/catch.hpp"
 
@@ -35,4 +36,25 @@ TEST_CASE("Basic test of sequence crypter") {
 
     SequenceDerived seq_crypter { Grafpe<>{key, iv, 128, 4, 100} };
     REQUIRE(seq_crypter.decrypt(seq_crypter.encrypt(msg)) == msg);
-}
\ No newline at end of file
+}
+
+TEST_CASE("Character-wise sequence crypter") {
+    const auto key = array_from_string<Grafpe<>::key_type>("0000111122223333");
+    const auto  iv = array_from_string<Grafpe<>::iv_type>("3333222211110000");
+
+    const auto alphabet = dfare::Alphabet{"abcdefghijklmnopqrstuvwxyz"};
+    auto crypter = rte::Characters{alphabet, Grafpe<>{key, iv, alphabet.characters().size(), 4, 100}};
+
+    for (std::string msg : {"helloworld", "a", "", "zzzzzzzzzzzzzzzzzzzz"}) {
+        auto encrypted = crypter.encrypt(msg, tweak_t{3});
+        REQUIRE(encrypted.size() == msg.size());
+        REQUIRE(std::all_of(encrypted.begin(), encrypted.end(), [](char c) { return c >= 'a' && c <= 'z'; }));
+        REQUIRE(crypter.decrypt(encrypted, tweak_t{3}) == msg);
+    }
+
+    std::string out = "name=";
+    crypter.encrypt_into("helloworld", out);
+    REQUIRE(out == "name=" + crypter.encrypt("helloworld"));
+
+    REQUIRE_THROWS_AS(crypter.encrypt("Hello"), std::out_of_range);
+}
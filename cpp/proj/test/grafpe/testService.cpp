@@ -0,0 +1,193 @@
+/*
+ * author: Adam Budziak
+ */
+
+#ifdef __linux__
+
+#include <cerrno>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <grafpe/aes/openssl/AesCtr128PRNG.hpp>
+#include <grafpe/common/print_utils.hpp>
+#include <grafpe/crypt/RadixGrafpe.hpp>
+#include <grafpe/crypt/ScalarGrafpe.hpp>
+#include <grafpe/service/Client.hpp>
+#include <grafpe/service/Server.hpp>
+#include "../catch/catch.hpp"
+
+namespace {
+
+/**
+ * Runs the server on its own thread, stopped and joined also when a REQUIRE throws.
+ */
+class server_thread {
+    grafpe::service::Server& m_server;
+    std::thread m_loop;
+
+ public:
+    explicit server_thread(grafpe::service::Server& server)
+      : m_server {server}, m_loop {[&server] { server.run(); }} { }
+
+    ~server_thread() {
+        m_server.stop();
+        m_loop.join();
+    }
+};
+
+}  // namespace
+
+TEST_CASE("Encryption daemon") {
+    using namespace grafpe;
+    using prng_t = aes::openssl::AesCtr128PRNG;
+
+    const auto key = hex_to_array<prng_t::key_type>("912C314E129436D3B23C506C424A32B6");
+    const auto  iv = hex_to_array<prng_t::iv_type>("CE438C4A1E3E92B707821B9E0599F62A");
+
+    auto scalar = crypter::ScalarGrafpe<prng_t>{key, iv, 1000, 4, 16};
+    auto radix = crypter::RadixGrafpe<prng_t>{key, iv, 123456, 4, 16};
+
+    const auto path = "/tmp/grafpe_test_service_" + std::to_string(getpid()) + ".sock";
+    service::Server server{path, {service::make_batch_crypter(scalar), service::make_batch_crypter(radix)}};
+    server_thread loop{server};
+
+    std::vector<uint64_t> values(1000);
+    for (uint64_t i = 0; i < values.size(); ++i) {
+        values[i] = i;
+    }
+
+    SECTION("The daemon encrypts like the crypters themselves") {
+        service::Client client{path};
+        std::vector<uint64_t> expected(values.size());
+
+        scalar.encrypt_batch(values.data(), expected.data(), values.size(), tweak_t{5});
+        auto encrypted = client.encrypt(0, values, tweak_t{5});
+        REQUIRE(encrypted == expected);
+        REQUIRE(client.decrypt(0, encrypted, tweak_t{5}) == values);
+
+        REQUIRE(client.encrypt(1, 123455) == radix.encrypt(123455));
+        REQUIRE(client.decrypt(1, client.encrypt(1, 77, tweak_t{3}), tweak_t{3}) == 77);
+        REQUIRE(client.encrypt(0, std::vector<uint64_t>{}).empty());
+    }
+
+    SECTION("Errors are reported and the connection stays usable") {
+        service::Client client{path};
+
+        try {
+            client.encrypt(2, 1);
+            FAIL("unknown crypter accepted");
+        } catch (const service::service_error& exc) {
+            REQUIRE(exc.status() == service::status_t::unknown_crypter);
+        }
+        // ScalarGrafpe itself would take it modulo 1000
+        for (auto op : {service::op_t::encrypt, service::op_t::decrypt}) {
+            try {
+                if (op == service::op_t::encrypt) {
+                    client.encrypt(0, std::vector<uint64_t>{1, 1000, 2});
+                } else {
+                    client.decrypt(0, std::vector<uint64_t>{1000});
+                }
+                FAIL("value outside of the domain accepted");
+            } catch (const service::service_error& exc) {
+                REQUIRE(exc.status() == service::status_t::invalid_value);
+            }
+        }
+        try {
+            client.encrypt(1, 123456);
+            FAIL("value outside of the domain accepted");
+        } catch (const service::service_error& exc) {
+            REQUIRE(exc.status() == service::status_t::invalid_value);
+        }
+        REQUIRE(client.encrypt(0, 7) == scalar.encrypt(7));
+    }
+
+    SECTION("Many clients at once") {
+        std::vector<std::vector<uint64_t>> results(4);
+        std::vector<std::thread> clients;
+        for (std::size_t c = 0; c < results.size(); ++c) {
+            clients.emplace_back([&, c] {
+                service::Client client{path};
+                for (std::size_t first = 0; first < values.size(); first += 100) {
+                    std::vector<uint64_t> batch(values.begin() + first, values.begin() + first + 100);
+                    auto encrypted = client.encrypt(0, batch, tweak_t{c});
+                    results[c].insert(results[c].end(), encrypted.begin(), encrypted.end());
+                }
+            });
+        }
+        for (auto& client : clients) {
+            client.join();
+        }
+        for (std::size_t c = 0; c < results.size(); ++c) {
+            std::vector<uint64_t> expected(values.size());
+            scalar.encrypt_batch(values.data(), expected.data(), values.size(), tweak_t{c});
+            REQUIRE(results[c] == expected);
+        }
+    }
+
+    SECTION("The socket of a running daemon isn't taken over") {
+        try {
+            service::Server other{path, {}};
+            FAIL("second daemon bound the same path");
+        } catch (const std::system_error& exc) {
+            REQUIRE(exc.code().value() == EADDRINUSE);
+        }
+        service::Client client{path};
+        REQUIRE(client.encrypt(0, 7) == scalar.encrypt(7));
+    }
+}
+
+TEST_CASE("Encryption daemon socket path") {
+    using namespace grafpe;
+
+    const auto path = "/tmp/grafpe_test_service_path_" + std::to_string(getpid()) + ".sock";
+    std::remove(path.c_str());
+
+    SECTION("Other files aren't removed") {
+        std::ofstream {path} << "data";
+        try {
+            service::Server server{path, {}};
+            FAIL("regular file replaced");
+        } catch (const std::system_error& exc) {
+            REQUIRE(exc.code().value() == EADDRINUSE);
+        }
+        REQUIRE(std::ifstream {path}.good());
+    }
+
+    SECTION("Stale sockets are replaced") {
+        // bound and closed without unlinking, like after a crash
+        sockaddr_un address {};
+        address.sun_family = AF_UNIX;
+        path.copy(address.sun_path, path.size());
+        const auto fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        REQUIRE(bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0);
+        close(fd);
+
+        {
+            service::Server server{path, {}};
+        }
+        struct stat info {};
+        REQUIRE(stat(path.c_str(), &info) < 0);
+    }
+
+    SECTION("A replaced socket file isn't removed") {
+        {
+            service::Server server{path, {}};
+            std::remove(path.c_str());
+            std::ofstream {path} << "data";
+        }
+        REQUIRE(std::ifstream {path}.good());
+    }
+
+    std::remove(path.c_str());
+}
+
+#endif
@@ -70,3 +70,64 @@ TEST_CASE("Basic test of tuple crypter") {
     auto result = tuple_crypter.encrypt("Kasia", perm_t{33}, "0110001000");
     REQUIRE(decltype(result){"Basia", perm_t{95}, "0001100000"} == result);
 }
+
+TEST_CASE("Columnar tuple encryption") {
+    using namespace grafpe;
+    using namespace aes::openssl;
+    using Grafpe = crypter::ScalarGrafpe<AesCtr128PRNG>;
+    using AgeCrypter = crypter::Grafpe<AesCtr128PRNG>;
+
+    std::vector<std::string> cities;
+    for (int i = 0; i < 500; ++i) {
+        cities.push_back("City-" + std::to_string(i));
+    }
+    auto regex_dfa = dfare::dfa::RankedDFA::from_string("0(0+1)*0", 10);
+
+    crypter::Tuple tuple_crypter {
+        rte::Container{cities, Grafpe{
+            hex_to_array<AesCtr128::key_type>("912C314E129436D3B23C506C424A32B6"),
+            hex_to_array<AesCtr128::iv_type>("CE438C4A1E3E92B707821B9E0599F62A"),
+            cities.size(), 4, 100}},
+        AgeCrypter{
+            hex_to_array<AesCtr128::key_type>("3EDB6F1706C55A835338C57E9161BF4B"),
+            hex_to_array<AesCtr128::iv_type>("19ACB9397671AA6767C90AA0C750B163"),
+            128, 4, 100},
+        rte::DFA{regex_dfa, Grafpe{
+            hex_to_array<AesCtr128::key_type>("09CAA86FF48E33EB037D1AA8BBF4A6EE"),
+            hex_to_array<AesCtr128::iv_type>("19DD37C0665252F84DCCEE00899534C2"),
+            regex_dfa.max_rank, 4, 100}},
+        Grafpe{
+            hex_to_array<AesCtr128::key_type>("01230123012332100123012301233210"),
+            hex_to_array<AesCtr128::iv_type>("32103210321032103210321032103210"),
+            100000, 4, 100}
+    };
+
+    decltype(tuple_crypter)::table_type table;
+    auto& [names, ages, codes, numbers] = table;
+    for (uint64_t row = 0; row < 300; ++row) {
+        names.push_back(cities[(row * 7) % cities.size()]);
+        ages.push_back(perm_t{row % 128, (row * 3) % 128});
+        codes.push_back(regex_dfa.unrank(row % regex_dfa.max_rank));
+        numbers.push_back(row * 331);
+    }
+
+    const tweak_t tweak {42};
+    for (bool parallel : {false, true}) {
+        auto encrypted = tuple_crypter.encrypt_columns(table, tweak, parallel);
+        for (std::size_t row = 0; row < names.size(); ++row) {
+            auto expected = tuple_crypter.encrypt(std::make_tuple(names[row], ages[row], codes[row], numbers[row]), tweak);
+            REQUIRE(std::make_tuple(std::get<0>(encrypted)[row], std::get<1>(encrypted)[row],
+                                    std::get<2>(encrypted)[row], std::get<3>(encrypted)[row]) == expected);
+        }
+        REQUIRE(tuple_crypter.decrypt_columns(encrypted, tweak, parallel) == table);
+    }
+
+    SECTION("Errors are reported") {
+        auto broken = table;
+        std::get<0>(broken)[10] = "Atlantis";
+        REQUIRE_THROWS_AS(tuple_crypter.encrypt_columns(broken, tweak, true), std::out_of_range);
+
+        std::get<3>(broken).pop_back();
+        REQUIRE_THROWS_AS(tuple_crypter.encrypt_columns(broken), std::invalid_argument);
+    }
+}
@@ -9,6 +9,9 @@
 
 #include <pur/containers/bitset.hpp>
 #include <pur/containers/bitset_view.hpp>
+#include <pur/containers/bit_cache.hpp>
+#include <pur/containers/lru_cache.hpp>
+#include <pur/memory/arena.hpp>
 
 #include "../catch/catch.hpp"
 
@@ -51,3 +54,100 @@ TEST_CASE("Test bitset view") {
 
     REQUIRE(bit_view.size() == 64);
 }
+
+TEST_CASE("Test bit cache") {
+    auto cache = pur::bit_cache{100};
+
+    REQUIRE(cache.capacity() == 128);
+    REQUIRE(!cache.find(7).has_value());
+
+    cache.insert(7, true);
+    cache.insert(8, false);
+
+    REQUIRE(cache.find(7).has_value());
+    REQUIRE(cache.find(7).value());
+    REQUIRE(cache.find(8).has_value());
+    REQUIRE(!cache.find(8).value());
+
+    REQUIRE(cache.stats().hits == 4);
+    REQUIRE(cache.stats().misses == 1);
+
+    SECTION("The capacity is never exceeded") {
+        for (size_t i = 0; i < 10 * cache.capacity(); ++i) {
+            cache.insert(i, i % 3 == 0);
+        }
+        size_t cached = 0;
+        for (size_t i = 0; i < 10 * cache.capacity(); ++i) {
+            if (auto value = cache.find(i); value.has_value()) {
+                REQUIRE(value.value() == (i % 3 == 0));
+                ++cached;
+            }
+        }
+        REQUIRE(cached <= cache.capacity());
+        REQUIRE(cache.stats().evictions > 0);
+    }
+
+    SECTION("Clearing drops the values and the statistics") {
+        cache.clear();
+        REQUIRE(cache.stats().lookups() == 0);
+        REQUIRE(!cache.find(7).has_value());
+    }
+}
+
+TEST_CASE("Test lru cache") {
+    auto cache = pur::lru_cache<int, std::string>{3};
+
+    REQUIRE(cache.find(1) == nullptr);
+    cache.insert(1, "one");
+    cache.insert(2, "two", 2);
+
+    REQUIRE(*cache.find(1) == "one");
+    REQUIRE(cache.cost() == 3);
+
+    SECTION("The least recently used value is evicted") {
+        auto two = cache.find(2);
+        cache.insert(3, "three");
+
+        REQUIRE(cache.find(1) == nullptr);
+        REQUIRE(*cache.find(3) == "three");
+        REQUIRE(cache.stats().evictions == 1);
+        REQUIRE(*two == "two");
+    }
+
+    SECTION("Values exceeding the capacity are not stored") {
+        REQUIRE(*cache.insert(4, "four", 4) == "four");
+        REQUIRE(cache.find(4) == nullptr);
+        REQUIRE(cache.size() == 2);
+    }
+
+    SECTION("Present keys are not overwritten") {
+        REQUIRE(*cache.insert(1, "uno") == "one");
+    }
+}
+
+TEST_CASE("Test arena") {
+    pur::arena arena{256};
+
+    auto first = static_cast<char*>(arena.allocate(10, 1));
+    auto second = static_cast<uint64_t*>(arena.allocate(sizeof(uint64_t), alignof(uint64_t)));
+
+    REQUIRE(reinterpret_cast<std::uintptr_t>(second) % alignof(uint64_t) == 0);
+    REQUIRE(reinterpret_cast<char*>(second) >= first + 10);
+    REQUIRE(arena.allocated_bytes() == 18);
+    REQUIRE(arena.reserved_bytes() == 256);
+
+    SECTION("Big allocations get their own blocks") {
+        arena.allocate(1000);
+        REQUIRE(arena.reserved_bytes() > 1256);
+    }
+
+    SECTION("Allocator for standard containers") {
+        auto shared = std::make_shared<pur::arena>();
+        std::vector<int, pur::arena_allocator<int>> values {pur::arena_allocator<int>{shared}};
+        for (int i = 0; i < 100; ++i) {
+            values.push_back(i);
+        }
+        REQUIRE(values[99] == 99);
+        REQUIRE(shared->allocated_bytes() >= 100 * sizeof(int));
+    }
+}